@@ -0,0 +1,730 @@
+// Microbenchmarks for the FaceSecure++ hot paths.
+//
+// All inputs are synthetic and generated from fixed seeds, so two runs on
+// the same machine measure the same work. Sizes that need several GB of RAM
+// or disk (100k-sample galleries, 10M-record logs) only run with --large.
+//
+//   FaceSecureBench [--filter TEXT] [--large] [--cascade FILE]
+
+#include "../include/core/AttendanceLogger.hpp"
+#include "../include/core/DetectorBackend.hpp"
+#include "../include/core/FaceDetector.hpp"
+#include "../include/core/FaceTracker.hpp"
+#include "../include/core/FaceRecognizer.hpp"
+#include "../include/core/GalleryFile.hpp"
+#include "../include/core/HistogramMatcher.hpp"
+#include "../include/core/MatPool.hpp"
+#include "../include/core/FaceQualityGate.hpp"
+#include "../include/core/MotionGate.hpp"
+#include "../include/core/RecognizerBackend.hpp"
+#include "../include/gui/ImageConversion.hpp"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/face.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint64_t kSeed = 0x5EED5EED;
+
+struct BenchConfig {
+    std::string filter;
+    bool large = false;
+    std::string cascadeFile = "data/haarcascade_frontalface_default.xml";
+    double minSeconds = 0.5;
+    int maxIterations = 1000;
+};
+
+BenchConfig config;
+
+bool selected(const std::string& name) {
+    return config.filter.empty() || name.find(config.filter) != std::string::npos;
+}
+
+// Time fn() until both a minimum duration and iteration count are reached,
+// then report mean and percentiles in microseconds.
+void measure(const std::string& name, const std::function<void()>& fn, int minIterations = 3) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+
+    fn(); // warm-up
+
+    Clock::time_point start = Clock::now();
+    while (static_cast<int>(samples.size()) < config.maxIterations) {
+        Clock::time_point before = Clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - before).count());
+
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (static_cast<int>(samples.size()) >= minIterations && elapsed >= config.minSeconds) {
+            break;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) total += sample;
+
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[index];
+    };
+
+    std::printf("%-44s %8zu %14.1f %14.1f %14.1f\n", name.c_str(), samples.size(),
+        total / samples.size(), percentile(0.50), percentile(0.95));
+    std::fflush(stdout);
+}
+
+// Deterministic face-like pattern; the identity seeds the geometry
+cv::Mat makeFace(cv::RNG& rng, int identity, int size) {
+    cv::RNG shape(kSeed + static_cast<uint64_t>(identity));
+    cv::Mat face(size, size, CV_8UC3);
+    rng.fill(face, cv::RNG::UNIFORM, cv::Scalar::all(40), cv::Scalar::all(90));
+
+    cv::Point center(size / 2, size / 2);
+    int skin = shape.uniform(120, 220);
+    cv::ellipse(face, center, cv::Size(size * 3 / 8, size * 9 / 20), 0, 0, 360,
+        cv::Scalar(skin - 30, skin - 10, skin), cv::FILLED);
+
+    int eyeOffset = size * shape.uniform(14, 22) / 100;
+    int eyeRadius = std::max(2, size * shape.uniform(4, 8) / 100);
+    cv::circle(face, center + cv::Point(-eyeOffset, -size / 10), eyeRadius, cv::Scalar::all(30), cv::FILLED);
+    cv::circle(face, center + cv::Point(eyeOffset, -size / 10), eyeRadius, cv::Scalar::all(30), cv::FILLED);
+    cv::ellipse(face, center + cv::Point(0, size / 5), cv::Size(size * shape.uniform(10, 20) / 100, size / 20),
+        0, 0, 180, cv::Scalar(40, 40, 150), std::max(1, size / 50));
+
+    // Per-sample noise so samples of one identity are not identical
+    cv::Mat noise(face.size(), face.type());
+    rng.fill(noise, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(16));
+    face += noise;
+    return face;
+}
+
+// Background frame with a few synthetic faces pasted in; their boxes go to
+// boxes when given
+cv::Mat makeFrame(cv::RNG& rng, cv::Size size, int faces, std::vector<cv::Rect>* boxes = nullptr) {
+    cv::Mat frame(size, CV_8UC3);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::GaussianBlur(frame, frame, cv::Size(7, 7), 0);
+
+    int faceSize = std::max(40, size.height / 5);
+    for (int i = 0; i < faces; ++i) {
+        int x = rng.uniform(0, size.width - faceSize);
+        int y = rng.uniform(0, size.height - faceSize);
+        makeFace(rng, i, faceSize).copyTo(frame(cv::Rect(x, y, faceSize, faceSize)));
+        if (boxes) {
+            boxes->push_back(cv::Rect(x, y, faceSize, faceSize));
+        }
+    }
+    return frame;
+}
+
+void benchDetector() {
+    FaceDetector detector;
+    if (!detector.initialize(config.cascadeFile)) {
+        std::printf("%-44s skipped (cascade not found: %s)\n", "detectFaces", config.cascadeFile.c_str());
+        return;
+    }
+
+    const cv::Size resolutions[] = {{320, 240}, {640, 480}, {1280, 720}, {1920, 1080}};
+    for (const auto& resolution : resolutions) {
+        std::string name = "detectFaces/" + std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+        if (!selected(name)) continue;
+
+        cv::RNG rng(kSeed);
+        cv::Mat frame = makeFrame(rng, resolution, 3);
+        measure(name, [&]() { detector.detectFaces(frame); });
+    }
+
+    // Coarse-to-fine with the minimum face at the size makeFrame pastes
+    for (const auto& resolution : resolutions) {
+        std::string name = "detectFaces/coarse/" + std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+        if (!selected(name)) continue;
+
+        cv::RNG rng(kSeed);
+        cv::Mat frame = makeFrame(rng, resolution, 3);
+        detector.setMinFaceSize(std::max(40, resolution.height / 5) * 2 / 3);
+        detector.setCoarseToFine(true);
+        measure(name, [&]() { detector.detectFaces(frame); });
+        detector.setCoarseToFine(false);
+        detector.setMinFaceSize(30);
+    }
+
+    // Several frames at once through one detector, one thread per core;
+    // compare with batch times detectFaces/640x480
+    const int batch = 8;
+    std::string name = "detectFaces/parallel/640x480x" + std::to_string(batch);
+    if (selected(name)) {
+        cv::RNG rng(kSeed);
+        std::vector<cv::Mat> frames;
+        for (int i = 0; i < batch; ++i) {
+            frames.push_back(makeFrame(rng, cv::Size(640, 480), 3));
+        }
+        unsigned threads = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), batch));
+        measure(name, [&]() {
+            std::atomic<int> next(0);
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&]() {
+                    int i;
+                    while ((i = next++) < batch) {
+                        detector.detectFaces(frames[i]);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+    }
+}
+
+// Every detector backend whose model is installed, on the same frames:
+// latency, then how many pasted faces each finds and how many boxes it
+// reports where there is no face. The faces are synthetic, so the counts
+// compare backends with each other rather than predict real-world recall.
+void benchDetectorBackends() {
+    const int frameCount = 20;
+    const cv::Size resolution(640, 480);
+
+    cv::RNG rng(kSeed);
+    std::vector<cv::Mat> frames;
+    std::vector<std::vector<cv::Rect>> truth(frameCount);
+    for (int i = 0; i < frameCount; ++i) {
+        frames.push_back(makeFrame(rng, resolution, 3, &truth[i]));
+    }
+
+    for (DetectorType type : DetectorBackend::allTypes()) {
+        std::string name = std::string("detectBackend/") + DetectorBackend::typeName(type) + "/640x480";
+        if (!selected(name)) continue;
+
+        FaceDetector detector;
+        std::string modelFile = type == DetectorType::HaarCascade ? config.cascadeFile : std::string();
+        if (!detector.initialize(type, modelFile)) {
+            std::printf("%-44s skipped (model not found: %s)\n", name.c_str(),
+                modelFile.empty() ? DetectorBackend::defaultModelFile(type) : modelFile.c_str());
+            continue;
+        }
+
+        size_t next = 0;
+        measure(name, [&]() { detector.detectFaces(frames[next++ % frames.size()]); });
+
+        int found = 0;
+        int expected = 0;
+        int falsePositives = 0;
+        for (int i = 0; i < frameCount; ++i) {
+            std::vector<cv::Rect> faces = detector.detectFaces(frames[i]);
+            std::vector<bool> matched(faces.size(), false);
+            for (const cv::Rect& face : truth[i]) {
+                expected++;
+                for (size_t j = 0; j < faces.size(); ++j) {
+                    double overlap = static_cast<double>((face & faces[j]).area()) / (face | faces[j]).area();
+                    if (!matched[j] && overlap >= 0.5) {
+                        matched[j] = true;
+                        found++;
+                        break;
+                    }
+                }
+            }
+            falsePositives += static_cast<int>(std::count(matched.begin(), matched.end(), false));
+        }
+        std::printf("%-44s found %d/%d faces, %d false positives\n", (name + "/accuracy").c_str(),
+            found, expected, falsePositives);
+    }
+}
+
+void benchMotionGate() {
+    const cv::Size resolutions[] = {{640, 480}, {1920, 1080}};
+    for (const auto& resolution : resolutions) {
+        std::string name = "motionGate/" + std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+        if (!selected(name)) continue;
+
+        // A static scene: every call after the first is a skip decision
+        cv::RNG rng(kSeed);
+        cv::Mat frame = makeFrame(rng, resolution, 0);
+        MotionGate gate;
+        measure(name, [&]() { gate.shouldDetect(frame); });
+    }
+}
+
+void benchFaceQualityGate() {
+    const int sizes[] = {64, 160, 320};
+    for (int size : sizes) {
+        std::string name = "faceQuality/" + std::to_string(size);
+        if (!selected(name)) continue;
+
+        // Thresholds open wide, so every check runs on every call
+        cv::RNG rng(kSeed);
+        cv::Mat frame = makeFrame(rng, cv::Size(640, 480), 0);
+        cv::Rect box(0, 0, size, size);
+        FaceQualityConfig quality;
+        quality.minBrightness = 0.0;
+        quality.maxBrightness = 255.0;
+        quality.minContrast = 0.0;
+        quality.minSharpness = 0.0;
+        FaceQualityGate gate(quality);
+        measure(name, [&]() { gate.check(frame, box); });
+    }
+}
+
+void benchPreprocess() {
+    const int sizes[] = {64, 100, 200, 400};
+    for (int size : sizes) {
+        std::string name = "preprocessFace/" + std::to_string(size) + "px";
+        if (!selected(name)) continue;
+
+        cv::RNG rng(kSeed);
+        cv::Mat face = makeFace(rng, 0, size);
+        measure(name, [&]() { FaceRecognizer::preprocessFace(face); });
+    }
+}
+
+// Enroll gallerySize synthetic samples, ten per identity; returns the
+// number of identities
+int enrollGallery(FaceRecognizer& recognizer, cv::RNG& rng, int gallerySize) {
+    const int samplesPerIdentity = 10;
+    int identities = std::max(1, gallerySize / samplesPerIdentity);
+    for (int identity = 0; identity < identities; ++identity) {
+        std::vector<cv::Mat> samples;
+        int count = std::min(samplesPerIdentity, gallerySize - identity * samplesPerIdentity);
+        for (int i = 0; i < count; ++i) {
+            samples.push_back(makeFace(rng, identity, 100));
+        }
+        recognizer.enroll("person" + std::to_string(identity), samples);
+    }
+    return identities;
+}
+
+void benchRecognizer() {
+    std::vector<int> gallerySizes = {10, 100, 1000, 10000};
+    if (config.large) {
+        gallerySizes.push_back(100000);
+    }
+
+    for (int gallerySize : gallerySizes) {
+        std::string name = "recognize/gallery=" + std::to_string(gallerySize);
+        // A crowded frame: eight faces in one call
+        std::string batchName = "recognizeBatch/faces=8/gallery=" + std::to_string(gallerySize);
+        // The HNSW index only pays off on large galleries
+        std::string approxName = "recognizeApprox/gallery=" + std::to_string(gallerySize);
+        bool approx = gallerySize >= 1000 && selected(approxName);
+        if (!selected(name) && !selected(batchName) && !approx) continue;
+
+        FaceRecognizer recognizer;
+        recognizer.initialize();
+        recognizer.setJournalFile("");
+
+        cv::RNG rng(kSeed);
+        int identities = enrollGallery(recognizer, rng, gallerySize);
+
+        if (selected(name)) {
+            cv::Mat probe = makeFace(rng, identities / 2, 100);
+            measure(name, [&]() {
+                double confidence = 0.0;
+                recognizer.recognize(probe, confidence);
+            });
+        }
+
+        if (selected(batchName)) {
+            std::vector<cv::Mat> probes;
+            for (int i = 0; i < 8; ++i) {
+                probes.push_back(makeFace(rng, (identities * i) / 8, 100));
+            }
+            measure(batchName, [&]() { recognizer.recognizeBatch(probes); });
+        }
+
+        if (approx) {
+            auto start = std::chrono::steady_clock::now();
+            recognizer.setApproximateSearch(true);
+            double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::vector<cv::Mat> probes;
+            for (int i = 0; i < 64; ++i) {
+                probes.push_back(makeFace(rng, (identities * i) / 64, 100));
+            }
+            cv::Mat probe = probes[probes.size() / 2];
+            measure(approxName, [&]() {
+                double confidence = 0.0;
+                recognizer.recognize(probe, confidence);
+            });
+            std::printf("%-44s index built in %.1f s, recall %.3f over %zu probes\n", "",
+                buildSeconds, recognizer.measureRecall(probes), probes.size());
+        }
+    }
+}
+
+// Every recognizer backend on the same synthetic gallery: time per face and
+// how many probes come back with the identity they were drawn from.
+// Subspace backends retrain on every enrollment, so the gallery stays small.
+void benchRecognizerBackends() {
+    const int gallerySize = 100;
+    const int probeCount = 64;
+
+    for (RecognizerType type : RecognizerBackend::allTypes()) {
+        std::string name = std::string("recognizeBackend/") + RecognizerBackend::typeName(type) +
+            "/gallery=" + std::to_string(gallerySize);
+        if (!selected(name)) continue;
+
+        FaceRecognizer recognizer;
+        if (!recognizer.initialize(type)) {
+            std::printf("%-44s skipped (model not found: %s)\n", name.c_str(),
+                RecognizerBackend::defaultModelFile(type));
+            continue;
+        }
+        recognizer.setJournalFile("");
+
+        cv::RNG rng(kSeed);
+        auto start = std::chrono::steady_clock::now();
+        int identities = enrollGallery(recognizer, rng, gallerySize);
+        double enrollSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<cv::Mat> probes;
+        for (int i = 0; i < probeCount; ++i) {
+            probes.push_back(makeFace(rng, i % identities, 100));
+        }
+
+        size_t next = 0;
+        measure(name, [&]() {
+            double confidence = 0.0;
+            recognizer.recognize(probes[next++ % probes.size()], confidence);
+        });
+
+        // Labels are handed out in enrollment order, starting at 0
+        int correct = 0;
+        std::vector<Recognition> results = recognizer.recognizeBatch(probes);
+        for (int i = 0; i < probeCount; ++i) {
+            if (results[i].label == i % identities) {
+                correct++;
+            }
+        }
+        std::printf("%-44s %d/%d probes matched, gallery built in %.2f s\n", (name + "/accuracy").c_str(),
+            correct, probeCount, enrollSeconds);
+    }
+}
+
+// Raw matcher throughput for LBPH histograms against compact embeddings,
+// with random rows so only size and metric differ
+void benchMatcherMetrics() {
+    struct Case {
+        const char* metricName;
+        HistogramMatcher::Metric metric;
+        int dims;
+        int gallerySize;
+    };
+    // 16384 values is the 8x8 grid of 256-bin LBPH histograms; 128 is SFace
+    const Case cases[] = {
+        {"chisquare", HistogramMatcher::Metric::ChiSquare, 16384, 10000},
+        {"cosine", HistogramMatcher::Metric::Cosine, 128, 10000},
+        {"cosine", HistogramMatcher::Metric::Cosine, 128, 100000},
+    };
+
+    for (const Case& c : cases) {
+        std::string name = std::string("matchMetric/") + c.metricName + "/dims=" + std::to_string(c.dims) +
+            "/gallery=" + std::to_string(c.gallerySize);
+        if (!selected(name)) continue;
+
+        HistogramMatcher matcher;
+        matcher.setMetric(c.metric);
+        cv::RNG rng(kSeed);
+        cv::Mat row(1, c.dims, CV_32F);
+        for (int i = 0; i < c.gallerySize; ++i) {
+            rng.fill(row, cv::RNG::UNIFORM, 0.0, 1.0);
+            if (c.metric == HistogramMatcher::Metric::Cosine) {
+                cv::normalize(row, row);
+            }
+            matcher.add(row, i);
+        }
+
+        rng.fill(row, cv::RNG::UNIFORM, 0.0, 1.0);
+        if (c.metric == HistogramMatcher::Metric::Cosine) {
+            cv::normalize(row, row);
+        }
+        measure(name, [&]() { matcher.nearest(row); });
+        std::printf("%-44s %zu bytes per sample (kernel %s)\n", "",
+            HistogramMatcher::rowStride(c.dims) * sizeof(float), HistogramMatcher::kernelName());
+    }
+}
+
+// Compare the recognizer's matcher with stock LBPHFaceRecognizer::predict
+// on the same gallery. Labels must agree and distances stay within a
+// relative tolerance, since the SIMD kernels sum in a different order.
+bool checkMatcherAgreement() {
+    const std::string name = "matcherAgreement";
+    if (!selected(name)) return true;
+
+    // 550 rows, over twice the matcher's parallel threshold (256 rows), so
+    // both the serial and the parallel scan are compared
+    const int identities = 110;
+    const int samplesPerIdentity = 5;
+    const int probes = 200;
+    const double tolerance = 1e-5;
+
+    FaceRecognizer recognizer;
+    recognizer.initialize();
+    recognizer.setJournalFile("");
+    cv::Ptr<cv::face::LBPHFaceRecognizer> reference = cv::face::LBPHFaceRecognizer::create();
+
+    cv::RNG rng(kSeed);
+    for (int identity = 0; identity < identities; ++identity) {
+        std::vector<cv::Mat> samples;
+        std::vector<cv::Mat> processed;
+        for (int i = 0; i < samplesPerIdentity; ++i) {
+            samples.push_back(makeFace(rng, identity, 100));
+            processed.push_back(FaceRecognizer::preprocessFace(samples.back()));
+        }
+        // Labels are handed out in enrollment order, starting at 0
+        recognizer.enroll("person" + std::to_string(identity), samples);
+        reference->update(processed, std::vector<int>(processed.size(), identity));
+    }
+
+    int labelMismatches = 0;
+    double worstError = 0.0;
+    for (int i = 0; i < probes; ++i) {
+        cv::Mat probe = makeFace(rng, i % identities, 100);
+        int expectedLabel = -1;
+        double expectedDistance = 0.0;
+        reference->predict(FaceRecognizer::preprocessFace(probe), expectedLabel, expectedDistance);
+
+        Recognition actual = recognizer.recognizeBatch({probe})[0];
+        if (actual.label != expectedLabel) {
+            labelMismatches++;
+        }
+        double error = std::abs(actual.confidence - expectedDistance) / std::max(expectedDistance, 1e-12);
+        worstError = std::max(worstError, error);
+    }
+
+    bool passed = labelMismatches == 0 && worstError <= tolerance;
+    std::printf("%-44s %s (kernel %s, %d probes, %d label mismatches, max relative error %.2e)\n",
+        name.c_str(), passed ? "ok" : "FAILED", HistogramMatcher::kernelName(), probes, labelMismatches, worstError);
+    return passed;
+}
+
+// Run the per-frame work the pipeline does (capture copy, motion gate,
+// detection, tracking with optical flow, face quality gate, face
+// preprocessing) and check that once warmed up it takes no new buffers
+// from the heap.
+bool checkPoolSteadyState() {
+    const std::string name = "framePool/640x480";
+    if (!selected(name)) return true;
+
+    const int warmupFrames = 10;
+    const int frames = 100;
+
+    FaceDetector detector;
+    bool detect = detector.initialize(config.cascadeFile);
+    MotionGate gate;
+    FaceQualityGate qualityGate;
+    TrackerConfig trackerConfig;
+    trackerConfig.opticalFlow = true;
+    FaceTracker tracker(trackerConfig);
+
+    cv::RNG rng(kSeed);
+    cv::Mat source = makeFrame(rng, cv::Size(640, 480), 3);
+    cv::Mat captured;
+    MatPool::usePool(captured);
+
+    auto runFrame = [&]() {
+        source.copyTo(captured);
+        gate.shouldDetect(captured);
+        std::vector<cv::Rect> faces;
+        if (detect) {
+            faces = detector.detectFaces(captured);
+        }
+        tracker.update(captured, faces);
+        for (const Track& track : tracker.getTracks()) {
+            cv::Rect box = track.box & cv::Rect(0, 0, captured.cols, captured.rows);
+            if (box.area() > 0) {
+                qualityGate.check(captured, box);
+                FaceRecognizer::preprocessFace(captured(box));
+            }
+        }
+        // A fixed face crop, so the gate and preprocessing run even without
+        // a cascade, whatever the gate decides about the synthetic pixels
+        cv::Rect fixed(100, 100, 120, 120);
+        qualityGate.check(captured, fixed);
+        FaceRecognizer::preprocessFace(captured(fixed));
+    };
+
+    for (int i = 0; i < warmupFrames; ++i) runFrame();
+    MatPoolStats before = MatPool::shared().stats();
+    for (int i = 0; i < frames; ++i) runFrame();
+    MatPoolStats after = MatPool::shared().stats();
+
+    uint64_t allocations = after.allocations - before.allocations;
+    bool passed = allocations == 0;
+    std::printf("%-44s %s (%d frames%s, %llu pool allocations, %llu reuses, %zu buffers cached)\n",
+        name.c_str(), passed ? "ok" : "FAILED", frames, detect ? "" : ", no cascade",
+        static_cast<unsigned long long>(allocations),
+        static_cast<unsigned long long>(after.reuses - before.reuses), after.cachedBuffers);
+    return passed;
+}
+
+// Write a synthetic attendance CSV with the given number of records
+void writeAttendanceLog(const std::string& path, size_t records) {
+    std::ofstream file(path);
+    file << "Name,Date,Time\n";
+    char line[64];
+    for (size_t i = 0; i < records; ++i) {
+        // 500 check-ins a day from a pool of 5000 people
+        int day = static_cast<int>(i / 500);
+        std::snprintf(line, sizeof(line), "person%d,%04d-%02d-%02d,08:%02d:%02d\n",
+            static_cast<int>(i % 5000), 2000 + day / 336, (day / 28) % 12 + 1, day % 28 + 1,
+            static_cast<int>((i / 60) % 60), static_cast<int>(i % 60));
+        file << line;
+    }
+}
+
+void benchAttendanceLogger() {
+    std::vector<size_t> recordCounts = {1000, 10000, 100000, 1000000};
+    if (config.large) {
+        recordCounts.push_back(10000000);
+    }
+
+    fs::path directory = fs::temp_directory_path() / "facesecure_bench";
+    fs::create_directories(directory);
+
+    for (size_t records : recordCounts) {
+        std::string suffix = "/records=" + std::to_string(records);
+        std::string loadName = "loadRecords" + suffix;
+        std::string logName = "logAttendance" + suffix;
+        if (!selected(loadName) && !selected(logName)) continue;
+
+        std::string path = (directory / ("attendance_" + std::to_string(records) + ".csv")).string();
+        writeAttendanceLog(path, records);
+
+        // Large logs take seconds per call; cap iterations so runs stay bounded
+        int minIterations = records >= 1000000 ? 1 : 3;
+
+        if (selected(loadName)) {
+            measure(loadName, [&]() { AttendanceLogger logger(path); }, minIterations);
+        }
+
+        if (selected(logName)) {
+            AttendanceLogger logger(path);
+            int next = 0;
+            measure(logName, [&]() { logger.logAttendance("visitor" + std::to_string(next++)); }, minIterations);
+        }
+    }
+
+    fs::remove_all(directory);
+}
+
+// Startup cost of a saved model: the YAML snapshot is parsed, the binary
+// gallery is mapped
+void benchModelLoad() {
+    std::vector<int> gallerySizes = {1000, 10000};
+    if (config.large) {
+        gallerySizes.push_back(100000);
+    }
+
+    fs::path directory = fs::temp_directory_path() / "facesecure_bench";
+    fs::create_directories(directory);
+
+    for (int gallerySize : gallerySizes) {
+        std::string suffix = "/gallery=" + std::to_string(gallerySize);
+        std::string yamlName = "loadModel/yaml" + suffix;
+        std::string binaryName = "loadModel/binary" + suffix;
+        // A 100k-sample YAML file is several GB of text
+        bool yaml = gallerySize <= 10000 && selected(yamlName);
+        if (!yaml && !selected(binaryName)) continue;
+
+        FaceRecognizer source;
+        source.initialize();
+        source.setJournalFile("");
+        cv::RNG rng(kSeed);
+        enrollGallery(source, rng, gallerySize);
+
+        std::string stem = (directory / ("model_" + std::to_string(gallerySize))).string();
+        if (yaml && source.saveModel(stem + ".yml")) {
+            measure(yamlName, [&]() {
+                FaceRecognizer recognizer;
+                recognizer.initialize();
+                recognizer.setJournalFile("");
+                recognizer.loadModel(stem + ".yml");
+            }, 1);
+        }
+        if (selected(binaryName) && source.saveModel(stem + GalleryFile::extension())) {
+            measure(binaryName, [&]() {
+                FaceRecognizer recognizer;
+                recognizer.initialize();
+                recognizer.setJournalFile("");
+                recognizer.loadModel(stem + GalleryFile::extension());
+            });
+        }
+    }
+
+    fs::remove_all(directory);
+}
+
+void benchMatToQImage() {
+    const cv::Size resolutions[] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    for (const auto& resolution : resolutions) {
+        std::string suffix = "/" + std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+        std::string name = "matToQImage" + suffix;
+        std::string wrapName = "wrapMat" + suffix;
+        // What the live view does per frame: fit a 640x480 tile
+        std::string scaledName = "scaledFrameImage" + suffix + "->640x480";
+        if (!selected(name) && !selected(wrapName) && !selected(scaledName)) continue;
+
+        cv::RNG rng(kSeed);
+        cv::Mat frame = makeFrame(rng, resolution, 0);
+        if (selected(name)) {
+            measure(name, [&]() { matToQImage(frame); });
+        }
+        if (selected(wrapName)) {
+            measure(wrapName, [&]() { wrapMat(frame); });
+        }
+        if (selected(scaledName)) {
+            measure(scaledName, [&]() { scaledFrameImage(frame, QSize(640, 480)); });
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else if (arg == "--cascade" && i + 1 < argc) {
+            config.cascadeFile = argv[++i];
+        } else if (arg == "--large") {
+            config.large = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--filter TEXT] [--large] [--cascade FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("FaceSecureBench (seed %llx, OpenCV %s, %d threads)\n\n",
+        static_cast<unsigned long long>(kSeed), CV_VERSION, cv::getNumThreads());
+    std::printf("%-44s %8s %14s %14s %14s\n", "benchmark", "iters", "mean (us)", "p50 (us)", "p95 (us)");
+
+    bool agreed = checkMatcherAgreement();
+    bool pooled = checkPoolSteadyState();
+
+    benchDetector();
+    benchDetectorBackends();
+    benchMotionGate();
+    benchFaceQualityGate();
+    benchPreprocess();
+    benchRecognizer();
+    benchRecognizerBackends();
+    benchMatcherMetrics();
+    benchModelLoad();
+    benchAttendanceLogger();
+    benchMatToQImage();
+    return agreed && pooled ? 0 : 1;
+}
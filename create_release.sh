@@ -50,6 +50,10 @@ chmod +x $TEMP_DIR/bin/run.sh
 cp install.sh $TEMP_DIR/
 chmod +x $TEMP_DIR/install.sh
 cp data/haarcascade_frontalface_default.xml $TEMP_DIR/data/
+for model in lbpcascade_frontalface_improved.xml face_detection_yunet_2023mar.onnx deploy.prototxt res10_300x300_ssd_iter_140000.caffemodel \
+    face_recognition_sface_2021dec.onnx; do
+  [ -f "data/$model" ] && cp "data/$model" $TEMP_DIR/data/
+done
 cp README.md $TEMP_DIR/
 
 # Create package
@@ -73,6 +77,10 @@ mkdir -p $TEMP_DIR/faces
 cp build/FaceSecure++ $TEMP_DIR/bin/
 cp install_windows.ps1 $TEMP_DIR/
 cp data/haarcascade_frontalface_default.xml $TEMP_DIR/data/
+for model in lbpcascade_frontalface_improved.xml face_detection_yunet_2023mar.onnx deploy.prototxt res10_300x300_ssd_iter_140000.caffemodel \
+    face_recognition_sface_2021dec.onnx; do
+  [ -f "data/$model" ] && cp "data/$model" $TEMP_DIR/data/
+done
 cp README.md $TEMP_DIR/
 
 # Create package
@@ -4,7 +4,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <iterator>
 
 struct AttendanceRecord {
     std::string name;
@@ -12,12 +16,81 @@ struct AttendanceRecord {
     std::string time;
 };
 
+// Read-only range over records picked out by an index, without copying
+// them. A view sees records appended later and is invalidated by clearLog().
+class RecordView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = AttendanceRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const AttendanceRecord*;
+        using reference = const AttendanceRecord&;
+
+        reference operator*() const { return (*view->records)[(*view->segments[segment])[offset]]; }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++() { ++offset; skipExhausted(); return *this; }
+        bool operator==(const const_iterator& other) const { return segment == other.segment && offset == other.offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+        // Position of the current record in the log
+        size_t position() const { return (*view->segments[segment])[offset]; }
+
+    private:
+        friend class RecordView;
+        const RecordView* view;
+        size_t segment;
+        size_t offset;
+
+        const_iterator(const RecordView* view, size_t segment) : view(view), segment(segment), offset(0) { skipExhausted(); }
+        void skipExhausted() {
+            while (segment < view->segments.size() && offset >= view->segments[segment]->size()) {
+                ++segment;
+                offset = 0;
+            }
+        }
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, segments.size()); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto* segment : segments) total += segment->size();
+        return total;
+    }
+    bool empty() const { return begin() == end(); }
+
+private:
+    friend class AttendanceLogger;
+    const std::vector<AttendanceRecord>* records = nullptr;
+    // Index lists of record positions, visited in order
+    std::vector<const std::vector<size_t>*> segments;
+};
+
+// When journaled check-ins are forced to disk and folded into the CSV
+struct CommitPolicy {
+    // fsync after this many check-ins...
+    size_t syncBatch = 16;
+    // ...or once the oldest unsynced check-in is this old
+    std::chrono::milliseconds syncInterval{1000};
+    // Rewrite the CSV and clear the journal after this many check-ins
+    size_t compactThreshold = 10000;
+};
+
+// Attendance is kept as a CSV snapshot plus an append-only journal
+// (<logFile>.journal). Each check-in appends one line to the journal; the
+// CSV is only rewritten when the journal is compacted.
 class AttendanceLogger {
 public:
     AttendanceLogger(const std::string& logFile = "data/attendance.csv");
-    ~AttendanceLogger() = default;
+    ~AttendanceLogger();
 
-    // Log attendance for a person
+    AttendanceLogger(const AttendanceLogger&) = delete;
+    AttendanceLogger& operator=(const AttendanceLogger&) = delete;
+
+    // Log attendance for a person. False if they were marked recently or the
+    // journal could not be written; the log is unchanged in both cases.
     bool logAttendance(const std::string& name);
     
     // Export attendance records to CSV
@@ -26,26 +99,82 @@ public:
     // Clear all attendance records
     void clearLog();
     
-    // Get all attendance records
+    // Get a copy of all attendance records (prefer allRecords())
     std::vector<AttendanceRecord> getRecords() const;
     
+    // All records in log order, by reference
+    const std::vector<AttendanceRecord>& allRecords() const;
+    
+    // Records on one date (YYYY-MM-DD)
+    RecordView recordsOn(const std::string& date) const;
+    
+    // Records from fromDate to toDate inclusive, in date order
+    RecordView recordsBetween(const std::string& fromDate, const std::string& toDate) const;
+    
+    // Records of one person, oldest first
+    RecordView recordsFor(const std::string& name) const;
+    
+    // Records whose name, or any word in it, starts with prefix (case-insensitive)
+    RecordView recordsMatching(const std::string& prefix) const;
+    
     // Check if person already marked attendance today
     bool isAlreadyMarked(const std::string& name) const;
+    
+    // Configure fsync batching and compaction
+    void setCommitPolicy(const CommitPolicy& policy);
+    
+    // Force journaled check-ins to disk
+    bool flush();
+    
+    // Flush if the oldest unsynced check-in has waited syncInterval. Check-ins
+    // only test this when they are appended, so call it periodically to
+    // cover the last check-in of a quiet spell.
+    bool flushIfDue();
+    
+    // Fold the journal into the CSV snapshot and clear it
+    bool compact();
 
 private:
     std::string logFile;
+    std::string journalFile;
     std::vector<AttendanceRecord> records;
     std::map<std::string, std::chrono::system_clock::time_point> lastMarked;
 
-    // Load existing records from file
+    // Secondary indexes: record positions per date and per name, and the
+    // lower-cased name and its words mapped to the names containing them
+    std::map<std::string, std::vector<size_t>> dateIndex;
+    std::map<std::string, std::vector<size_t>> nameIndex;
+    std::map<std::string, std::set<std::string>> wordIndex;
+
+    CommitPolicy policy;
+    std::FILE* journal;
+    size_t journalRecords;
+    size_t unsyncedRecords;
+    std::chrono::steady_clock::time_point oldestUnsynced;
+
+    // Load the CSV snapshot and replay the journal on top of it
     bool loadRecords();
     
-    // Save records to file
-    bool saveRecords();
+    // Add records[index] to the secondary indexes
+    void indexRecord(size_t index);
+    
+    // Drop and rebuild every secondary index
+    void rebuildIndexes();
+    
+    RecordView makeView() const;
+    
+    // Append one record to the journal, syncing per the commit policy
+    bool appendToJournal(const AttendanceRecord& record);
+    
+    // Open the journal for appending, optionally discarding its contents
+    bool openJournal(bool truncate);
+    
+    // Write every record as CSV, optionally forcing it to disk
+    bool writeCSV(const std::string& filename, bool sync) const;
     
     // Get current date/time as string
     std::string getCurrentDate() const;
     std::string getCurrentTime() const;
 };
 
-#endif // ATTENDANCE_LOGGER_HPP 
\ No newline at end of file
+#endif // ATTENDANCE_LOGGER_HPP
@@ -0,0 +1,89 @@
+#ifndef BATCH_PROCESSOR_HPP
+#define BATCH_PROCESSOR_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "DetectorBackend.hpp"
+#include "FaceRecognizer.hpp"
+
+struct BatchOptions {
+    // Video files and/or directories of images
+    std::vector<std::string> inputs;
+    // Detector backend and its model files; empty paths use the bundled model
+    DetectorType detector = DetectorType::HaarCascade;
+    std::string detectorModel;
+    std::string detectorConfig;
+    // Worker threads; 0 uses every core
+    unsigned threads = 0;
+    // Process every Nth frame of a video
+    int frameStride = 1;
+    // Frames (or images) per work unit; long videos are split into segments
+    int segmentFrames = 600;
+    // Smallest face to detect; 0 keeps the detector's full-frame default,
+    // anything else detects coarse-to-fine at that size
+    int minFaceSize = 0;
+};
+
+// First sighting of a known person in one input
+struct AttendanceEvent {
+    std::string source;
+    int64_t frame = 0;
+    // Offset into the recording, or -1 for still images
+    double seconds = -1.0;
+    std::string name;
+    double confidence = 0.0;
+};
+
+// Throughput for one input
+struct BatchFileStats {
+    std::string source;
+    uint64_t frames = 0;
+    uint64_t faces = 0;
+    double wallSeconds = 0.0;
+    // Mean time the detector spent per processed frame
+    double detectMs = 0.0;
+    // Duration of the recording, 0 for image directories
+    double mediaSeconds = 0.0;
+};
+
+// Runs detection and recognition over recorded inputs without a display.
+// Inputs are split into segments that worker threads pull from a shared
+// list, sharing one FaceDetector and the read-only recognizer.
+class BatchProcessor {
+public:
+    using EventCallback = std::function<void(const AttendanceEvent&)>;
+    using StatsCallback = std::function<void(const BatchFileStats&)>;
+
+    BatchProcessor(FaceRecognizer& recognizer, const BatchOptions& options);
+    ~BatchProcessor() = default;
+
+    // Process every input. Callbacks fire once per input when it completes,
+    // serialized, with events in recording order. Returns false if any input
+    // could not be opened.
+    bool run(EventCallback onEvent, StatsCallback onStats);
+
+private:
+    struct WorkUnit {
+        size_t input = 0;
+        bool isVideo = true;
+        int64_t begin = 0;
+        int64_t end = -1;
+        std::vector<std::string> images;
+    };
+
+    FaceRecognizer& recognizer;
+    BatchOptions options;
+
+    // Split every input into work units; false if an input is unusable
+    bool planWork(std::vector<WorkUnit>& units, std::vector<double>& mediaSeconds);
+
+    // Position a capture exactly on a frame, decoding forward from wherever
+    // the backend's seek lands; false if the video ends first
+    static bool seekToFrame(cv::VideoCapture& capture, const std::string& source, int64_t frame);
+
+    static bool isImageFile(const std::string& path);
+};
+
+#endif // BATCH_PROCESSOR_HPP
@@ -0,0 +1,83 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Fixed-capacity, thread-safe FIFO used to link pipeline stages.
+// Closing the queue wakes all waiters; pop() keeps draining queued items
+// and only returns false once the queue is both closed and empty.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity = 2) : capacity(capacity > 0 ? capacity : 1), closed(false) {}
+
+    // Block until there is room, then enqueue. Returns false if closed.
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Enqueue without blocking, discarding the oldest item when full.
+    // Returns the number of items dropped (0 or 1), or -1 if closed.
+    int pushLatest(T item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) return -1;
+        int dropped = 0;
+        if (items.size() >= capacity) {
+            items.pop_front();
+            dropped = 1;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return dropped;
+    }
+
+    // Block until an item is available. Returns false once closed and drained.
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Stop accepting new items and wake every waiting thread
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    // Drop queued items, optionally resize, and accept pushes again
+    void reset(size_t newCapacity = 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.clear();
+        if (newCapacity > 0) capacity = newCapacity;
+        closed = false;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+private:
+    size_t capacity;
+    bool closed;
+    std::deque<T> items;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+#endif // BOUNDED_QUEUE_HPP
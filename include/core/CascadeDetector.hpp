@@ -0,0 +1,45 @@
+#ifndef CASCADE_DETECTOR_HPP
+#define CASCADE_DETECTOR_HPP
+
+#include <opencv2/objdetect.hpp>
+#include <string>
+#include "DetectorBackend.hpp"
+#include "InstancePool.hpp"
+
+// Haar or LBP cascade. A cv::CascadeClassifier keeps per-image state while
+// it runs, so the cascade file is read once and every concurrent caller
+// gets its own classifier parsed from that copy.
+class CascadeDetector : public DetectorBackend {
+public:
+    explicit CascadeDetector(DetectorType type = DetectorType::HaarCascade);
+
+    // Read and check the cascade; false if it cannot be parsed
+    bool load(const std::string& cascadeFile);
+
+    DetectorType type() const override;
+    std::vector<cv::Rect> detect(const cv::Mat& frame, int minFace, bool coarseToFine) const override;
+
+    // Classifiers created so far
+    size_t instances() const;
+
+private:
+    DetectorType cascadeType;
+    std::string cascadeFile;
+    // File contents, parsed again for every new classifier
+    std::string cascadeData;
+    cv::Size window;
+    mutable InstancePool<cv::CascadeClassifier> classifiers;
+
+    std::unique_ptr<cv::CascadeClassifier> createClassifier() const;
+
+    // Single pass over the full-resolution frame
+    static void detectFullFrame(cv::CascadeClassifier& classifier, const cv::Mat& frame, int minFace,
+                                std::vector<cv::Rect>& faces);
+
+    // Downscaled pass followed by per-candidate refinement; candidates the
+    // full-resolution pass does not confirm are dropped
+    static void detectCoarseToFine(cv::CascadeClassifier& classifier, const cv::Mat& frame, int minFace,
+                                   double scale, std::vector<cv::Rect>& faces);
+};
+
+#endif // CASCADE_DETECTOR_HPP
@@ -0,0 +1,49 @@
+#ifndef DETECTOR_BACKEND_HPP
+#define DETECTOR_BACKEND_HPP
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class DetectorType {
+    // Viola-Jones Haar cascade; the long-standing default
+    HaarCascade,
+    // LBP cascade: integer features, the cheapest backend
+    LbpCascade,
+    // YuNet CNN through cv::FaceDetectorYN (OpenCV 4.5.4 or later)
+    YuNet,
+    // ResNet-10 SSD (Caffe) through cv::dnn
+    ResNetSsd
+};
+
+// One way of finding faces in a frame. Backends hold the loaded model and
+// are shared between detectors and threads, so detect() must be safe to
+// call concurrently.
+class DetectorBackend {
+public:
+    virtual ~DetectorBackend() = default;
+
+    virtual DetectorType type() const = 0;
+
+    // Faces at least minFace pixels across. coarseToFine lets a backend
+    // trade accuracy on small faces for speed on large frames.
+    virtual std::vector<cv::Rect> detect(const cv::Mat& frame, int minFace, bool coarseToFine) const = 0;
+
+    // Load a backend. Empty paths select the bundled model under data/;
+    // configFile is only used by backends that need two files (the SSD's
+    // prototxt). Returns null if the model cannot be loaded.
+    static std::shared_ptr<DetectorBackend> create(DetectorType type, const std::string& modelFile = std::string(),
+                                                   const std::string& configFile = std::string());
+
+    static const char* defaultModelFile(DetectorType type);
+    static const char* defaultConfigFile(DetectorType type);
+
+    // Short names used in settings and on the command line
+    // ("haar", "lbp", "yunet", "ssd")
+    static const char* typeName(DetectorType type);
+    static bool parseType(const std::string& name, DetectorType& type);
+    static std::vector<DetectorType> allTypes();
+};
+
+#endif // DETECTOR_BACKEND_HPP
@@ -0,0 +1,47 @@
+#ifndef DNN_DETECTOR_HPP
+#define DNN_DETECTOR_HPP
+
+#include <opencv2/core.hpp>
+#include <string>
+#include "DetectorBackend.hpp"
+#include "InstancePool.hpp"
+
+// CNN face detectors run on the CPU through OpenCV's dnn module: YuNet
+// (cv::FaceDetectorYN) or the ResNet-10 SSD. Far fewer false positives
+// than a cascade on textured backgrounds, at a higher cost per frame.
+// Networks keep their input blobs between calls, so every concurrent
+// caller gets its own instance loaded from the same files.
+class DnnDetector : public DetectorBackend {
+public:
+    // type must be YuNet or ResNetSsd
+    explicit DnnDetector(DetectorType type);
+    ~DnnDetector() override;
+
+    // Load the network and run it once; false if it cannot be loaded or
+    // this OpenCV build lacks the backend
+    bool load(const std::string& modelFile, const std::string& configFile = std::string());
+
+    DetectorType type() const override;
+
+    // The SSD always looks at a 300x300 view of the frame. YuNet runs at
+    // full resolution unless coarseToFine is set, in which case the frame
+    // is shrunk until minFace reaches the smallest face YuNet finds well.
+    std::vector<cv::Rect> detect(const cv::Mat& frame, int minFace, bool coarseToFine) const override;
+
+private:
+    struct Network;
+
+    DetectorType networkType;
+    std::string modelFile;
+    std::string configFile;
+    // Detections below this score are dropped
+    float scoreThreshold;
+    mutable InstancePool<Network> networks;
+
+    std::unique_ptr<Network> createNetwork() const;
+    void detectYuNet(Network& network, const cv::Mat& frame, int minFace, bool coarseToFine,
+                     std::vector<cv::Rect>& faces) const;
+    void detectSsd(Network& network, const cv::Mat& frame, int minFace, std::vector<cv::Rect>& faces) const;
+};
+
+#endif // DNN_DETECTOR_HPP
@@ -0,0 +1,101 @@
+#ifndef ENROLLMENT_SESSION_HPP
+#define ENROLLMENT_SESSION_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FaceDetector.hpp"
+
+struct EnrollmentConfig {
+    // Camera index ("0", "1", ...) or a video file / stream URL
+    std::string source = "0";
+    // Face images handed to the recognizer
+    int samples = 5;
+    // Candidates are collected for at least this long
+    std::chrono::milliseconds burst{2000};
+    // Give up if there are still too few usable candidates by then
+    std::chrono::milliseconds timeout{10000};
+    // Candidates scoring below this are never selected
+    double minQuality = 0.25;
+    // Most candidates kept while the burst runs; the weakest go first
+    size_t maxCandidates = 40;
+};
+
+// One crop seen during the burst and how it scored. All scores are in [0, 1].
+struct EnrollmentCandidate {
+    cv::Mat face;
+    double sharpness = 0.0;
+    double size = 0.0;
+    double brightness = 0.0;
+    double quality = 0.0;
+    // Small normalized gray copy; distances between these stand in for
+    // differences in pose and expression
+    cv::Mat thumbnail;
+};
+
+struct EnrollmentProgress {
+    // Usable candidates so far and how many the session needs
+    int candidates = 0;
+    int needed = 0;
+    double bestQuality = 0.0;
+    // Frame with the detections drawn on it
+    cv::Mat preview;
+};
+
+struct EnrollmentResult {
+    bool success = false;
+    std::string error;
+    // Selected crops, best first, with their quality
+    std::vector<cv::Mat> faces;
+    std::vector<double> qualities;
+};
+
+// Captures a short burst from a camera on a background thread, scores every
+// single-face crop and keeps the best diverse set. Callbacks run on the
+// session thread.
+class EnrollmentSession {
+public:
+    using ProgressCallback = std::function<void(EnrollmentProgress&&)>;
+    using FinishedCallback = std::function<void(EnrollmentResult&&)>;
+
+    explicit EnrollmentSession(FaceDetector& detector);
+    ~EnrollmentSession();
+
+    EnrollmentSession(const EnrollmentSession&) = delete;
+    EnrollmentSession& operator=(const EnrollmentSession&) = delete;
+
+    // Open the source and start capturing. Returns false if a session is
+    // already running or the source cannot be opened.
+    bool start(const EnrollmentConfig& config, ProgressCallback onProgress, FinishedCallback onFinished);
+
+    // Stop capturing and wait for the thread; onFinished is not called
+    void cancel();
+
+    bool isRunning() const;
+
+    // Score a face crop for sharpness, size and brightness
+    static EnrollmentCandidate score(const cv::Mat& face);
+
+    // Indices of up to count candidates, best first. Each pick trades its
+    // quality against its distance to the ones already picked.
+    static std::vector<size_t> select(const std::vector<EnrollmentCandidate>& candidates, int count);
+
+private:
+    FaceDetector& detector;
+    EnrollmentConfig config;
+    cv::VideoCapture capture;
+    ProgressCallback progressCallback;
+    FinishedCallback finishedCallback;
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<bool> cancelled;
+
+    bool openSource(const std::string& source);
+    void captureLoop();
+};
+
+#endif // ENROLLMENT_SESSION_HPP
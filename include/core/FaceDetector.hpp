@@ -2,30 +2,86 @@
 #define FACE_DETECTOR_HPP
 
 #include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "DetectorBackend.hpp"
 
+// Result of one detect() call
+struct Detection {
+    std::vector<cv::Rect> faces;
+    // Copy of the frame with the faces drawn; empty unless asked for
+    cv::Mat annotated;
+    // Time the backend spent on this frame
+    double milliseconds = 0.0;
+};
+
+// Per-frame detection latency since the last reset
+struct DetectorStats {
+    DetectorType type = DetectorType::HaarCascade;
+    uint64_t frames = 0;
+    double meanMs = 0.0;
+    double lastMs = 0.0;
+    double maxMs = 0.0;
+};
+
+// Face detection through a pluggable backend (Haar or LBP cascade, or a
+// DNN). Detection keeps no state between calls and the backends are safe to
+// share, so any number of threads may detect through one FaceDetector at
+// once. Initialization is not meant to race with detection; the setters'
+// values are read atomically at the start of each call.
 class FaceDetector {
 public:
     FaceDetector();
     ~FaceDetector() = default;
 
-    // Initialize the face detector with cascade classifier
+    // Initialize the face detector with a Haar cascade
     bool initialize(const std::string& cascadeFile = "data/haarcascade_frontalface_default.xml");
     
-    // Detect faces in the given frame
-    std::vector<cv::Rect> detectFaces(const cv::Mat& frame);
+    // Load another backend; empty paths use its bundled model under data/
+    bool initialize(DetectorType type, const std::string& modelFile = std::string(),
+                    const std::string& configFile = std::string());
+    
+    // Share an already loaded backend, e.g. between the detectors of
+    // several streams
+    bool initialize(std::shared_ptr<DetectorBackend> backend);
+    std::shared_ptr<DetectorBackend> getBackend() const;
+    
+    // Detect faces in the given frame, optionally returning a copy of it
+    // with the faces drawn
+    Detection detect(const cv::Mat& frame, bool annotate = false) const;
     
-    // Get the current frame with detected faces drawn
-    cv::Mat getAnnotatedFrame() const;
+    // Shorthand for detect(frame).faces
+    std::vector<cv::Rect> detectFaces(const cv::Mat& frame) const;
+    
+    // Latency of the frames this detector has processed
+    DetectorStats getStats() const;
+    void resetStats();
+    
+    // Smallest face, in pixels, that detection has to find
+    void setMinFaceSize(int pixels);
+    int getMinFaceSize() const;
+    
+    // Trade accuracy on small faces for speed on large frames. Cascades
+    // detect on a frame downscaled so the minimum face just fits their
+    // window, then refine each candidate at full resolution.
+    void setCoarseToFine(bool enabled);
+    bool isCoarseToFine() const;
+    
+    // Draw rectangles around detected faces
+    static void drawFaceRectangles(cv::Mat& frame, const std::vector<cv::Rect>& faces);
 
 private:
-    cv::CascadeClassifier faceClassifier;
-    cv::Mat currentFrame;
-    std::vector<cv::Rect> currentFaces;
+    std::shared_ptr<DetectorBackend> backend;
+    std::atomic<int> minFaceSize;
+    std::atomic<bool> coarseToFine;
     
-    // Draw rectangles around detected faces
-    void drawFaceRectangles();
+    mutable std::atomic<uint64_t> frames;
+    mutable std::atomic<uint64_t> totalMicros;
+    mutable std::atomic<uint64_t> lastMicros;
+    mutable std::atomic<uint64_t> maxMicros;
 };
 
 #endif // FACE_DETECTOR_HPP 
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef FACE_QUALITY_GATE_HPP
+#define FACE_QUALITY_GATE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+
+struct FaceQualityConfig {
+    bool enabled = true;
+    // Smallest face side, in frame pixels, worth recognizing
+    int minSize = 40;
+    // Laplacian variance of the crop at analysis size; lower is blurrier
+    double minSharpness = 30.0;
+    // Acceptable mean gray level of the crop
+    double minBrightness = 40.0;
+    double maxBrightness = 220.0;
+    // Gray-level standard deviation below which the face is washed out
+    double minContrast = 15.0;
+    // Width / height of the box after clipping to the frame. Faces cut off
+    // by the frame edge or partly hidden come out narrow or squat.
+    double minAspect = 0.65;
+    double maxAspect = 1.5;
+};
+
+enum class FaceRejection {
+    None,
+    TooSmall,
+    Blurred,
+    Exposure,
+    Aspect
+};
+
+// Faces seen by the gate since the last reset, by outcome
+struct FaceQualityStats {
+    uint64_t passed = 0;
+    uint64_t tooSmall = 0;
+    uint64_t blurred = 0;
+    uint64_t exposure = 0;
+    uint64_t aspect = 0;
+
+    uint64_t rejected() const { return tooSmall + blurred + exposure + aspect; }
+};
+
+// Cheap checks run on a face box before it is sent to the recognizer.
+// Faces that fail them could never match the gallery reliably, so the
+// gallery scan is skipped and the face is tried again on a later frame.
+// The cheapest checks run first; only size and aspect need no pixels.
+class FaceQualityGate {
+public:
+    explicit FaceQualityGate(const FaceQualityConfig& config = FaceQualityConfig());
+    ~FaceQualityGate() = default;
+
+    // Why this face should not be recognized, or None
+    FaceRejection check(const cv::Mat& frame, const cv::Rect& box);
+
+    // Counters may be read from any thread while check() runs
+    FaceQualityStats stats() const;
+
+    void reset();
+    void setConfig(const FaceQualityConfig& config);
+
+    static const char* reasonName(FaceRejection reason);
+
+private:
+    FaceQualityConfig config;
+    cv::Mat gray;
+    cv::Mat small;
+    cv::Mat laplacian;
+    std::atomic<uint64_t> passed;
+    std::atomic<uint64_t> tooSmall;
+    std::atomic<uint64_t> blurred;
+    std::atomic<uint64_t> exposure;
+    std::atomic<uint64_t> aspect;
+
+    FaceRejection evaluate(const cv::Mat& frame, const cv::Rect& box);
+};
+
+#endif // FACE_QUALITY_GATE_HPP
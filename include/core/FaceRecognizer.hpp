@@ -2,38 +2,158 @@
 #define FACE_RECOGNIZER_HPP
 
 #include <opencv2/opencv.hpp>
-#include <opencv2/face.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include "GalleryFile.hpp"
+#include "GalleryJournal.hpp"
+#include "HistogramMatcher.hpp"
+#include "HnswIndex.hpp"
+#include "RecognizerBackend.hpp"
 
+// Outcome of recognizing one face
+struct Recognition {
+    std::string name = "Unknown";
+    // Distance scaled so that 100 is the acceptance limit of every backend
+    double confidence = 0.0;
+    int label = -1;
+};
+
+// Recognition only reads the gallery and may run on any number of threads
+// at once, e.g. one per camera. Enrolling, removing, loading, saving and
+// changing the search mode must not overlap it.
 class FaceRecognizer {
 public:
     FaceRecognizer();
     ~FaceRecognizer() = default;
 
-    // Initialize the face recognizer
-    bool initialize();
+    // Switch to a backend and start over with an empty gallery, journaled
+    // to the backend's own file. modelFile is only used by network
+    // backends. On failure the previous backend stays in place.
+    bool initialize(RecognizerType type = RecognizerType::Lbph, const std::string& modelFile = std::string());
+    
+    RecognizerType getType() const;
+    
+    // Enrolled people
+    size_t identityCount() const;
+    
+    // Names of the enrolled people, each once
+    std::vector<std::string> identityNames() const;
+    
+    // Add a person to the gallery without retraining existing identities.
+    // The enrollment is journaled first; if that fails the gallery is left
+    // unchanged and false is returned.
+    bool enroll(const std::string& name, const std::vector<cv::Mat>& faceImages);
+    
+    // Remove every sample of a person. Journaled first like an enrollment;
+    // if that fails the gallery is left unchanged and false is returned.
+    bool remove(const std::string& name);
     
-    // Train the recognizer with new face images
+    // Train the recognizer with new face images (same as enroll)
     bool train(const std::string& name, const std::vector<cv::Mat>& faceImages);
     
     // Recognize a face from the given image
     std::string recognize(const cv::Mat& faceImage, double& confidence);
     
-    // Save the trained model
-    bool saveModel(const std::string& filename = "data/trained_model.yml");
+    // Recognize many faces at once, from one frame or several. Faces are
+    // preprocessed and matched in parallel; results keep the input order.
+    std::vector<Recognition> recognizeBatch(const std::vector<cv::Mat>& faceImages);
+    
+    // Write a full snapshot of the model and names, then clear the journal.
+    // Files ending in GalleryFile::extension() are written in the binary
+    // gallery format, anything else as OpenCV YAML. Subspace backends keep
+    // their training faces, which only YAML holds. An empty name selects
+    // the backend's default file.
+    bool saveModel(const std::string& filename = std::string());
+    
+    // Load the last snapshot and replay the journal on top of it. Binary
+    // galleries are memory-mapped; the format is detected from the contents.
+    // Snapshots made by another backend are rejected. The current gallery
+    // is replaced; true if the snapshot loaded or the journal added anyone,
+    // so a missing snapshot does not make it fail.
+    bool loadModel(const std::string& filename = std::string());
+    
+    // Rewrite a snapshot in the format chosen by the destination's extension
+    // and verify the result. The backend is detected from the source. The
+    // journal is neither replayed nor cleared.
+    static bool convertModel(const std::string& source, const std::string& destination);
+    
+    // Where enrollments are journaled between snapshots
+    void setJournalFile(const std::string& filename);
+    
+    // Enrollments not yet folded into a snapshot
+    size_t pendingJournalRecords() const;
+    
+    // Search an HNSW index instead of scanning every sample. efSearch trades
+    // speed for recall. loadModel() only reads a saved index while this is
+    // on, so enable it before loading; enabling later builds the index,
+    // which takes a while on large galleries.
+    void setApproximateSearch(bool enabled, int efSearch = 32);
+    bool isApproximateSearch() const;
     
-    // Load a trained model
-    bool loadModel(const std::string& filename = "data/trained_model.yml");
+    // Fraction of faces for which the index finds the same nearest sample
+    // as the exhaustive scan
+    double measureRecall(const std::vector<cv::Mat>& faceImages);
+    
+    // Equalized 100x100 gray face, the input of the classical backends
+    static cv::Mat preprocessFace(const cv::Mat& faceImage);
+    
+    // Prepare a face crop for the current backend
+    cv::Mat preprocess(const cv::Mat& faceImage) const;
+    
+    // Descriptor of a preprocessed face; empty while the backend is untrained
+    cv::Mat describe(const cv::Mat& processed) const;
 
 private:
-    cv::Ptr<cv::face::LBPHFaceRecognizer> model;
+    // Turns faces into descriptors; the gallery itself lives in matcher
+    std::shared_ptr<RecognizerBackend> backend;
+    HistogramMatcher matcher;
+    // Graph over matcher rows, kept next to the snapshot as <model>.hnsw
+    HnswIndex index;
+    bool approximate;
     std::map<int, std::string> labelNames;
     int nextLabel;
-
-    // Prepare face image for recognition
-    cv::Mat preprocessFace(const cv::Mat& faceImage);
+    GalleryJournal journal;
+    // Preprocessed faces and their labels, kept for backends that train on
+    // the gallery; matcher row i then describes samples[i]
+    std::vector<cv::Mat> samples;
+    std::vector<int> sampleLabels;
+    // Set while replaying the journal, so training runs once at the end
+    bool trainingDeferred;
+    
+    // Match one preprocessed face against the gallery
+    Recognition match(const cv::Mat& processed) const;
+    
+    // Add already preprocessed samples under the given label
+    bool addSamples(int label, const std::string& name, const std::vector<cv::Mat>& processedImages);
+    
+    // Describe new samples for a backend that is not trained on the gallery;
+    // false if any of them cannot be described
+    bool describeAll(const std::vector<cv::Mat>& processedImages, std::vector<cv::Mat>& descriptors) const;
+    
+    // Put checked samples into the gallery. descriptors is ignored by
+    // trainable backends, which describe everything again.
+    void applySamples(int label, const std::string& name, const std::vector<cv::Mat>& processedImages,
+                      const std::vector<cv::Mat>& descriptors);
+    
+    // Drop a label's samples from the matcher and the index
+    void removeLabel(int label);
+    
+    // Train a subspace backend on the kept samples and describe them all
+    // again. Until training succeeds (Fisherfaces needs two people) the
+    // gallery has no rows and every face is Unknown.
+    bool retrain();
+    
+    // OpenCV YAML snapshots. LBPH uses the layout LBPHFaceRecognizer writes;
+    // other backends store their model next to the descriptors or samples.
+    bool saveYaml(const std::string& filename) const;
+    bool loadYaml(const std::string& filename);
+    
+    // Backend a snapshot was written by
+    static bool snapshotType(const std::string& filename, RecognizerType& type);
+    
+    static bool hasExtension(const std::string& filename, const std::string& extension);
 };
 
-#endif // FACE_RECOGNIZER_HPP 
\ No newline at end of file
+#endif // FACE_RECOGNIZER_HPP
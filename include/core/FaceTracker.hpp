@@ -0,0 +1,73 @@
+#ifndef FACE_TRACKER_HPP
+#define FACE_TRACKER_HPP
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+struct TrackerConfig {
+    // Minimum overlap for a detection to continue an existing track
+    double iouThreshold = 0.3;
+    // Frames a track survives without a matching detection
+    int maxMissedFrames = 5;
+    // Frames between re-recognitions of an identified track; 0 never re-checks
+    int reverifyInterval = 30;
+    // Frames between retries while a track is still "Unknown"
+    int unknownRetryInterval = 5;
+    // Follow faces the detector missed with sparse optical flow
+    bool opticalFlow = false;
+};
+
+// A face followed across frames
+struct Track {
+    int id = 0;
+    cv::Rect box;
+    std::string name = "Unknown";
+    double confidence = 0.0;
+    // Whether the track has been recognized at least once
+    bool recognized = false;
+    // Frames since the last recognition
+    int sinceRecognition = 0;
+    // Frames since the last matching detection
+    int missed = 0;
+    // Seen in the latest frame, by detection or optical flow
+    bool visible = false;
+};
+
+// Associates per-frame detections with stable track IDs by greedy IoU
+// matching, so the recognizer only has to run when a track is new or due
+// for re-verification.
+class FaceTracker {
+public:
+    explicit FaceTracker(const TrackerConfig& config = TrackerConfig());
+    ~FaceTracker() = default;
+
+    // Match this frame's detections against the live tracks
+    void update(const cv::Mat& frame, const std::vector<cv::Rect>& detections);
+
+    // Whether a track should be (re)recognized in this frame
+    bool needsRecognition(const Track& track) const;
+
+    // Record the recognizer's verdict for a track
+    void setIdentity(int trackId, const std::string& name, double confidence);
+
+    const std::vector<Track>& getTracks() const;
+
+    // Drop all tracks, e.g. when the video source changes
+    void reset();
+
+    void setConfig(const TrackerConfig& config);
+
+private:
+    TrackerConfig config;
+    std::vector<Track> tracks;
+    int nextId;
+    cv::Mat previousGray;
+
+    // Shift a box by the median flow of the features inside it
+    bool propagate(const cv::Mat& gray, cv::Rect& box) const;
+
+    static double iou(const cv::Rect& a, const cv::Rect& b);
+};
+
+#endif // FACE_TRACKER_HPP
@@ -0,0 +1,22 @@
+#ifndef FILE_SYNC_HPP
+#define FILE_SYNC_HPP
+
+#include <cstdio>
+#include <string>
+
+// Push buffered writes of an open file through to the storage device
+bool syncFile(std::FILE* file);
+
+// Same for a file another writer has already closed, e.g. cv::FileStorage
+bool syncFile(const std::string& path);
+
+// Make a rename or a new entry in the directory holding path durable.
+// Always succeeds on Windows, which has no directory handles to flush.
+bool syncParentDirectory(const std::string& path);
+
+// Rename temporary over path, then sync the directory, so after a crash
+// path holds either the old or the new contents. The temporary is removed
+// if the rename fails.
+bool replaceFile(const std::string& temporary, const std::string& path);
+
+#endif // FILE_SYNC_HPP
@@ -0,0 +1,149 @@
+#ifndef FRAME_PIPELINE_HPP
+#define FRAME_PIPELINE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.hpp"
+#include "FaceDetector.hpp"
+#include "FaceRecognizer.hpp"
+#include "FaceQualityGate.hpp"
+#include "FaceTracker.hpp"
+#include "IdentityVoter.hpp"
+#include "MotionGate.hpp"
+
+// Recognition outcome for a single detected face
+struct FaceResult {
+    cv::Rect box;
+    std::string name;
+    double confidence = 0.0;
+    // Stable ID of the track this face belongs to
+    int trackId = 0;
+    // Set on the one frame in which voting commits the track's identity;
+    // attendance is logged on this frame only
+    bool committed = false;
+};
+
+// Finished frame handed to the presentation callback. The frame holds the
+// captured pixels unchanged; faces are reported separately.
+struct FrameResult {
+    uint64_t frameIndex = 0;
+    cv::Mat frame;
+    std::vector<FaceResult> faces;
+};
+
+struct PipelineConfig {
+    // Camera index ("0", "1", ...) or a video file / stream URL
+    std::string source = "0";
+    // Capacity of each inter-stage queue
+    size_t queueCapacity = 2;
+    // Drop the oldest queued frame instead of stalling capture (live cameras)
+    bool dropFrames = true;
+    // Pin the detect and recognize stages to separate CPU cores
+    bool pinThreads = true;
+    // Core for the detect stage when pinned; recognize uses the next one
+    unsigned firstCore = 1;
+    // Face tracking; each track is recognized once and re-verified on schedule
+    TrackerConfig tracker;
+    // Skip detection on frames without motion and reuse the last faces
+    MotionGateConfig motionGate;
+    // Keep faces that cannot match out of the recognizer
+    FaceQualityConfig faceQuality;
+    // Recognitions of a track must agree before its identity is committed
+    VoterConfig voting;
+};
+
+// Capture -> detect -> recognize -> present, each stage on its own thread and
+// linked by bounded queues. Only finished frames leave the pipeline, through
+// the result callback, which runs on the present thread.
+class FramePipeline {
+public:
+    using ResultCallback = std::function<void(FrameResult&&)>;
+    // Called on the present thread once the last frame has been delivered,
+    // whether the source ended or stop() was called
+    using FinishedCallback = std::function<void()>;
+
+    FramePipeline(FaceDetector& detector, FaceRecognizer& recognizer);
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Open the source and start all stages
+    bool start(const PipelineConfig& config, ResultCallback onResult, FinishedCallback onFinished = nullptr);
+
+    // Stop all stages and wait for them to finish
+    void stop();
+
+    bool isRunning() const;
+
+    // Frames discarded by capture because downstream stages were busy
+    uint64_t droppedFrames() const;
+
+    // Faces passed to the recognizer since start()
+    uint64_t recognizerCalls() const;
+
+    // Frames whose detection was skipped for lack of motion
+    uint64_t skippedDetections() const;
+
+    // Frames delivered to the result callback since start()
+    uint64_t processedFrames() const;
+
+    // Faces the quality gate passed or kept from the recognizer since start()
+    FaceQualityStats faceQualityStats() const;
+
+    // Identities committed by voting since start()
+    uint64_t identityCommits() const;
+
+private:
+    struct FramePacket {
+        uint64_t index = 0;
+        cv::Mat frame;
+        std::vector<cv::Rect> faces;
+        std::vector<FaceResult> results;
+    };
+
+    FaceDetector& detector;
+    FaceRecognizer& recognizer;
+    PipelineConfig config;
+    ResultCallback onResult;
+    FinishedCallback onFinished;
+    cv::VideoCapture capture;
+    FaceTracker tracker;
+    MotionGate motionGate;
+    FaceQualityGate qualityGate;
+    IdentityVoter voter;
+
+    BoundedQueue<FramePacket> detectQueue;
+    BoundedQueue<FramePacket> recognizeQueue;
+    BoundedQueue<FramePacket> presentQueue;
+
+    std::thread captureThread;
+    std::thread detectThread;
+    std::thread recognizeThread;
+    std::thread presentThread;
+
+    std::atomic<bool> running;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> recognitions;
+    std::atomic<uint64_t> skipped;
+    std::atomic<uint64_t> processed;
+
+    // Stage loops
+    void captureLoop();
+    void detectLoop();
+    void recognizeLoop();
+    void presentLoop();
+
+    // Open a device index or a file path
+    bool openSource(const std::string& source);
+
+    // Bind the calling thread to one CPU core (best effort)
+    static void pinToCore(unsigned core);
+};
+
+#endif // FRAME_PIPELINE_HPP
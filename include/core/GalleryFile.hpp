@@ -0,0 +1,54 @@
+#ifndef GALLERY_FILE_HPP
+#define GALLERY_FILE_HPP
+
+#include <cfloat>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "HistogramMatcher.hpp"
+
+// Recognizer the rows were computed with, and its LBPH parameters
+struct GalleryParams {
+    int radius = 1;
+    int neighbors = 8;
+    int gridX = 8;
+    int gridY = 8;
+    double threshold = DBL_MAX;
+    // RecognizerType, as an integer
+    int recognizer = 0;
+    // Checksum of the histogram rows, as stored in the header; filled in
+    // by readParams() and open(), ignored by write()
+    uint64_t rowsChecksum = 0;
+};
+
+// Binary gallery snapshot: a fixed header, the labels, the label names and
+// the descriptor matrix in HistogramMatcher's padded layout. Every section is
+// checksummed. Loading maps the file read-only and hands the histogram rows
+// to the matcher in place, so startup does not depend on the gallery size
+// and processes opening the same file share its pages.
+class GalleryFile {
+public:
+    // File name extension that selects this format when saving
+    static const char* extension();
+
+    // True if the file starts with a gallery header
+    static bool isGalleryFile(const std::string& path);
+
+    // Header fields only, without mapping the rows
+    static bool readParams(const std::string& path, GalleryParams& params);
+
+    // Write the live rows of a matcher, replacing path atomically
+    static bool write(const std::string& path, const GalleryParams& params,
+                      const HistogramMatcher& matcher, const std::map<int, std::string>& names);
+
+    // Map a gallery and attach its rows to matcher. The header, labels and
+    // names are always verified; verifyRows also checks the histogram
+    // checksum, which reads the whole file.
+    static bool open(const std::string& path, GalleryParams& params, HistogramMatcher& matcher,
+                     std::map<int, std::string>& names, bool verifyRows = false);
+
+    // The rows checksum write() would store for a matcher's live rows
+    static uint64_t rowsChecksum(const HistogramMatcher& matcher);
+};
+
+#endif // GALLERY_FILE_HPP
@@ -0,0 +1,50 @@
+#ifndef GALLERY_JOURNAL_HPP
+#define GALLERY_JOURNAL_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// One enrollment: a label, its display name and the preprocessed samples.
+// An entry without samples records the removal of the label.
+struct GalleryEntry {
+    int label = -1;
+    std::string name;
+    std::vector<cv::Mat> faces;
+};
+
+// Append-only log of enrollments made since the last model snapshot.
+// Each record is written with a single append and carries a checksum, so a
+// crash mid-write leaves at most one torn record at the tail, which replay
+// ignores. An empty path disables journaling.
+class GalleryJournal {
+public:
+    explicit GalleryJournal(const std::string& path = "data/gallery.journal");
+    ~GalleryJournal() = default;
+
+    // Append one enrollment (8-bit samples, gray or color); true once the
+    // record has been synced to disk
+    bool append(const GalleryEntry& entry);
+
+    // Feed every intact record to apply(), oldest first
+    bool replay(const std::function<void(GalleryEntry&&)>& apply);
+
+    // Drop all records, e.g. after they were folded into a snapshot
+    bool truncate();
+
+    // Number of records appended or replayed since the last truncate
+    size_t recordCount() const;
+
+    void setPath(const std::string& path);
+    const std::string& getPath() const;
+
+private:
+    std::string path;
+    size_t records;
+
+    static uint32_t checksum(const std::string& bytes);
+};
+
+#endif // GALLERY_JOURNAL_HPP
@@ -0,0 +1,63 @@
+#ifndef GREETING_CACHE_HPP
+#define GREETING_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Synthesized greeting: mono 16-bit PCM and the voice it was rendered with
+struct GreetingClip {
+    int sampleRate = 0;
+    int speed = 0;
+    int pitch = 0;
+    std::vector<int16_t> samples;
+};
+
+// Rendered greetings keyed by name, speed and pitch. Recently played clips
+// stay in memory; every clip is also kept as a small file in the cache
+// directory, so greetings survive restarts without being synthesized again.
+// Not thread-safe: VoiceGreeter only touches it from its audio thread.
+class GreetingCache {
+public:
+    explicit GreetingCache(const std::string& directory = "data/greetings", size_t memoryClips = 128);
+
+    // Clip for a name in the given voice, from memory or disk; null if it
+    // was never rendered
+    std::shared_ptr<const GreetingClip> find(const std::string& name, int speed, int pitch);
+
+    // Keep a clip in memory and write it to disk
+    bool store(const std::string& name, std::shared_ptr<const GreetingClip> clip);
+
+    // Forget every clip rendered with another voice, in memory and on disk
+    void invalidate(int speed, int pitch);
+
+    // Clips held in memory
+    size_t size() const;
+
+private:
+    using Recent = std::list<std::string>;
+
+    struct Entry {
+        std::shared_ptr<const GreetingClip> clip;
+        Recent::iterator recent;
+    };
+
+    std::string directory;
+    size_t capacity;
+    // Key is name plus voice; most recently used first in recent
+    std::map<std::string, Entry> entries;
+    Recent recent;
+
+    void remember(const std::string& key, std::shared_ptr<const GreetingClip> clip);
+    std::string filePath(const std::string& name, int speed, int pitch) const;
+
+    static std::string key(const std::string& name, int speed, int pitch);
+    static std::shared_ptr<const GreetingClip> readClip(const std::string& path, const std::string& name);
+    static bool writeClip(const std::string& path, const std::string& name, const GreetingClip& clip);
+};
+
+#endif // GREETING_CACHE_HPP
@@ -0,0 +1,133 @@
+#ifndef HISTOGRAM_MATCHER_HPP
+#define HISTOGRAM_MATCHER_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cfloat>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Allocator for SIMD-friendly buffers
+template<typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+    template<typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Nearest-neighbour search over face descriptors. LBPH spatial histograms
+// use the same chi-square distance (HISTCMP_CHISQR_ALT) as
+// LBPHFaceRecognizer::predict; subspace projections use Euclidean distance
+// and unit-length embeddings cosine distance. Descriptors live in one
+// 64-byte aligned matrix with rows padded to whole cache lines. Rows are
+// scanned in parallel with AVX2 or NEON kernels when the CPU has them, and
+// a row stops being scored once its partial distance exceeds the best
+// match found so far. The matrix can also be borrowed from a read-only
+// mapping (see GalleryFile); it is copied on the first change.
+class HistogramMatcher {
+public:
+    using Buffer = std::vector<float, AlignedAllocator<float, 64>>;
+
+    struct Match {
+        int index = -1;
+        int label = -1;
+        double distance = DBL_MAX;
+    };
+
+    enum class Metric {
+        ChiSquare,
+        // 1 - dot product; rows and queries must already be unit length
+        Cosine,
+        Euclidean
+    };
+
+    HistogramMatcher();
+    ~HistogramMatcher() = default;
+
+    // Distance used by nearest() and distance(); kept across clear()
+    void setMetric(Metric metric);
+    Metric metric() const;
+
+    // Append one histogram (a single row of CV_32F values)
+    void add(const cv::Mat& histogram, int label);
+
+    void clear();
+    size_t size() const;
+
+    // Use rows stored elsewhere, kept alive by owner. rows must be 64-byte
+    // aligned, with rowStride() floats per row and zeros after dims.
+    void attach(std::shared_ptr<const void> storage, const float* first, int dimensions, std::vector<int> rowLabels);
+
+    // True while the rows are borrowed rather than owned
+    bool isAttached() const;
+
+    // Copy borrowed rows into memory owned by the matcher
+    void detach();
+
+    // Floats per stored row for histograms of the given size
+    static size_t rowStride(int dims);
+
+    // Values per histogram, 0 while empty
+    int dimensions() const;
+
+    int labelAt(size_t index) const;
+
+    // Row of the stored histogram, without padding; shares the matrix memory
+    cv::Mat histogramAt(size_t index) const;
+
+    // Closest stored histogram; the first row wins ties, as in OpenCV
+    Match nearest(const cv::Mat& query) const;
+
+    // Copy a query into the aligned, padded layout distance() expects
+    void prepareQuery(const cv::Mat& query, Buffer& padded) const;
+
+    // Distance from one row to a prepared query; returns early with a value
+    // above bound once the row cannot beat it
+    double distance(size_t index, const float* query, double bound = DBL_MAX) const;
+
+    // Padded row, usable as a prepared query
+    const float* rowData(size_t index) const;
+
+    // Drop every row of a label; rows keep their indices until compact()
+    std::vector<size_t> removeLabel(int label);
+    bool isRemoved(size_t index) const;
+    size_t removedCount() const;
+
+    // Close the gaps left by removeLabel(); row indices change
+    void compact();
+
+    // Instruction set of the distance kernels picked for this CPU
+    static const char* kernelName();
+
+private:
+    using Kernel = double (*)(const float* a, const float* b, size_t n, double bound);
+
+    Metric distanceMetric;
+    // Kernel for distanceMetric on this CPU
+    Kernel kernel;
+    int dims;
+    // Floats per row, a multiple of one cache line
+    size_t stride;
+    Buffer data;
+    // First row; points into data unless the rows are attached
+    const float* rows;
+    std::shared_ptr<const void> owner;
+    // Label per row, -1 once removed
+    std::vector<int> labels;
+    size_t removed;
+};
+
+#endif // HISTOGRAM_MATCHER_HPP
@@ -0,0 +1,111 @@
+#ifndef HNSW_INDEX_HPP
+#define HNSW_INDEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "HistogramMatcher.hpp"
+
+struct HnswConfig {
+    // Links per node on the upper layers; layer 0 keeps twice as many
+    int M = 16;
+    // Candidate list size while inserting
+    int efConstruction = 100;
+    // Candidate list size while searching; higher trades speed for recall
+    int efSearch = 32;
+};
+
+// Hierarchical navigable small world graph over the rows of a
+// HistogramMatcher, using the matcher's distance kernels and metric.
+// The index stores only graph links; node i is matcher row i. Removed rows
+// stay in the graph for navigation but are never returned.
+class HnswIndex {
+public:
+    explicit HnswIndex(const HistogramMatcher& store, const HnswConfig& config = HnswConfig());
+    ~HnswIndex() = default;
+
+    // Link the next matcher row into the graph; rows must be inserted in order
+    void insert(size_t row);
+
+    // Index every matcher row that is not linked yet, in parallel
+    void build();
+
+    // Exclude a row from search results
+    void markDeleted(size_t row);
+
+    // Approximate nearest row to a prepared query (see HistogramMatcher::prepareQuery)
+    HistogramMatcher::Match nearest(const float* query) const;
+
+    // Nodes in the graph, including deleted ones
+    size_t size() const;
+
+    void clear();
+
+    void setEfSearch(int ef);
+    const HnswConfig& getConfig() const;
+
+    // Persist the graph. rowsChecksum identifies the rows it was built over,
+    // normally the gallery snapshot's stored checksum; load() fails unless
+    // it and the store's size, dimensions and labels all match.
+    bool save(const std::string& path, uint64_t rowsChecksum) const;
+    bool load(const std::string& path, uint64_t rowsChecksum);
+
+private:
+    struct Node {
+        // links[level] holds neighbor ids on that layer
+        std::vector<std::vector<uint32_t>> links;
+        bool deleted = false;
+    };
+
+    struct Candidate {
+        double distance;
+        uint32_t id;
+        bool operator<(const Candidate& other) const { return distance < other.distance; }
+        bool operator>(const Candidate& other) const { return distance > other.distance; }
+    };
+
+    const HistogramMatcher& store;
+    HnswConfig config;
+    std::vector<Node> nodes;
+    // One lock per node guards its links while build() runs in parallel
+    std::unique_ptr<std::mutex[]> nodeLocks;
+    size_t lockCount;
+    // Set while build() or insert() links nodes; searches lock only then
+    std::atomic<bool> building;
+    // Guards entryPoint and maxLevel
+    mutable std::mutex entryLock;
+    int64_t entryPoint;
+    int maxLevel;
+    std::mt19937 rng;
+
+    // Grow nodes (and their locks) to cover the store; levels are drawn here
+    void allocate(size_t count);
+
+    // Connect an allocated node to the graph
+    void link(uint32_t id);
+
+    // A node's links on one layer; copied into scratch under the node's
+    // lock while the graph is being built, read in place otherwise
+    const std::vector<uint32_t>& neighbors(uint32_t id, int level, std::vector<uint32_t>& scratch) const;
+
+    // Greedy walk from fromLevel down to stopLevel + 1; returns the closest node
+    uint32_t descend(const float* query, uint32_t entry, int fromLevel, int stopLevel) const;
+
+    // Best-first search of one layer; returns up to ef closest, nearest first
+    std::vector<Candidate> searchLayer(const float* query, uint32_t entry, int ef, int level) const;
+
+    // Keep neighbors that are closer to the node than to each other
+    std::vector<uint32_t> selectNeighbors(const std::vector<Candidate>& candidates, size_t count) const;
+
+    // Trim a node's links on one layer back to the layer's limit
+    void shrinkLinks(uint32_t id, int level);
+
+    int randomLevel();
+    size_t maxLinks(int level) const;
+};
+
+#endif // HNSW_INDEX_HPP
@@ -0,0 +1,80 @@
+#ifndef IDENTITY_VOTER_HPP
+#define IDENTITY_VOTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include "FaceTracker.hpp"
+
+struct VoterConfig {
+    // Recognitions remembered per track
+    size_t window = 10;
+    // Votes the leading name needs before it can be committed
+    int minVotes = 3;
+    // Share of the window the leading name needs; always more than half
+    double requiredShare = 0.85;
+    // The two latest recognitions naming the same person, each at least
+    // this strong (1 is a perfect match, 0 the acceptance limit), commit
+    // without waiting for minVotes
+    double strongMatch = 0.5;
+    // A name committed by one track is not committed again by another
+    // within this time, e.g. when a track breaks up and restarts
+    std::chrono::seconds recommitAfter{60};
+};
+
+// Temporal decision layer between the recognizer and attendance. Every
+// recognition of a tracked face is a vote; a track's identity is committed
+// once, when enough recent votes agree, so a single misidentified frame
+// never reaches the log. Used from one thread; commits() may be read from
+// any thread.
+class IdentityVoter {
+public:
+    explicit IdentityVoter(const VoterConfig& config = VoterConfig());
+    ~IdentityVoter() = default;
+
+    // Add one recognition of a track. Returns true if it commits the
+    // track's identity; committedName() then holds it.
+    bool observe(int trackId, const std::string& name, double confidence);
+
+    // Whether recognizing this track again could still lead to a commit
+    bool wantsEvidence(int trackId) const;
+
+    // Identity committed for a track, or an empty string
+    std::string committedName(int trackId) const;
+
+    // Forget tracks that are no longer followed
+    void retain(const std::vector<Track>& live);
+
+    // Identities committed since the last reset
+    uint64_t commits() const;
+
+    void reset();
+    void setConfig(const VoterConfig& config);
+
+    // Map the 0-100 confidence threshold setting onto requiredShare, from
+    // a simple (strict) majority to a unanimous window
+    static double shareForThreshold(int threshold);
+
+private:
+    struct Vote {
+        std::string name;
+        // Match strength in [0, 1]
+        double strength = 0.0;
+    };
+
+    struct TrackVotes {
+        std::deque<Vote> votes;
+        std::string committed;
+    };
+
+    VoterConfig config;
+    std::map<int, TrackVotes> tracks;
+    std::map<std::string, std::chrono::steady_clock::time_point> lastCommit;
+    std::atomic<uint64_t> committedCount;
+};
+
+#endif // IDENTITY_VOTER_HPP
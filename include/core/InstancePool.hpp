@@ -0,0 +1,104 @@
+#ifndef INSTANCE_POOL_HPP
+#define INSTANCE_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Checkout pool for objects that carry per-call state and so cannot be
+// shared between threads, such as cascade classifiers and DNN nets. A
+// caller leases an idle instance, or a new one when all are busy, and the
+// lease puts it back when it ends. The pool therefore grows to the highest
+// number of threads that ever used it at the same time.
+template <typename T>
+class InstancePool {
+public:
+    // Builds a new instance; may return null on failure
+    using Factory = std::function<std::unique_ptr<T>()>;
+
+    // Exclusive use of one instance until destroyed
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept : pool(other.pool), instance(std::move(other.instance)) {
+            other.pool = nullptr;
+        }
+
+        ~Lease() {
+            if (pool && instance) {
+                pool->release(std::move(instance));
+            }
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        // False if the factory could not build an instance
+        explicit operator bool() const { return instance != nullptr; }
+
+        T& operator*() const { return *instance; }
+        T* operator->() const { return instance.get(); }
+
+    private:
+        friend class InstancePool;
+        Lease(InstancePool* pool, std::unique_ptr<T> instance) : pool(pool), instance(std::move(instance)) {}
+
+        InstancePool* pool;
+        std::unique_ptr<T> instance;
+    };
+
+    explicit InstancePool(Factory factory) : factory(std::move(factory)), created(0) {}
+
+    InstancePool(const InstancePool&) = delete;
+    InstancePool& operator=(const InstancePool&) = delete;
+
+    Lease acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                std::unique_ptr<T> instance = std::move(idle.back());
+                idle.pop_back();
+                return Lease(this, std::move(instance));
+            }
+        }
+
+        // Build outside the lock; other threads keep taking and returning
+        // instances meanwhile
+        std::unique_ptr<T> instance = factory();
+        if (instance) {
+            std::lock_guard<std::mutex> lock(mutex);
+            created++;
+        }
+        return Lease(this, std::move(instance));
+    }
+
+    // Hand over an instance built elsewhere, e.g. the one used to validate
+    // a model at load time
+    void add(std::unique_ptr<T> instance) {
+        if (!instance) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(std::move(instance));
+        created++;
+    }
+
+    // Instances built so far
+    size_t instances() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return created;
+    }
+
+private:
+    Factory factory;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<T>> idle;
+    size_t created;
+
+    void release(std::unique_ptr<T> instance) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(std::move(instance));
+    }
+};
+
+#endif // INSTANCE_POOL_HPP
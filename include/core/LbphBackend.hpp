@@ -0,0 +1,28 @@
+#ifndef LBPH_BACKEND_HPP
+#define LBPH_BACKEND_HPP
+
+#include <opencv2/face.hpp>
+#include "RecognizerBackend.hpp"
+
+// LBPH spatial histograms of 100x100 equalized gray faces, computed the
+// way LBPHFaceRecognizer computes them and compared with chi-square
+// distance, so distances match what LBPHFaceRecognizer::predict reports
+class LbphBackend : public RecognizerBackend {
+public:
+    LbphBackend();
+
+    RecognizerType type() const override;
+    cv::Mat preprocess(const cv::Mat& faceImage) const override;
+    cv::Mat describe(const cv::Mat& processed) const override;
+    HistogramMatcher::Metric metric() const override;
+    double acceptDistance() const override;
+
+    GalleryParams galleryParams() const override;
+    void setGalleryParams(const GalleryParams& params) override;
+
+private:
+    // Holds the LBPH parameters; never trained
+    cv::Ptr<cv::face::LBPHFaceRecognizer> model;
+};
+
+#endif // LBPH_BACKEND_HPP
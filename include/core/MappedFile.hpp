@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are loaded on first
+// access and shared with every other process mapping the same file.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+
+    // Start of the mapping; page aligned
+    const char* data() const;
+    size_t size() const;
+
+private:
+    const char* base;
+    size_t length;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+};
+
+#endif // MAPPED_FILE_HPP
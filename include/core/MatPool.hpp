@@ -0,0 +1,66 @@
+#ifndef MAT_POOL_HPP
+#define MAT_POOL_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Counters for verifying that a steady stream of frames allocates nothing
+struct MatPoolStats {
+    // Buffers taken from the heap
+    uint64_t allocations = 0;
+    // Buffers handed out again from the pool
+    uint64_t reuses = 0;
+    // Buffers given back to the heap because the pool was full
+    uint64_t frees = 0;
+    // Buffers currently parked in the pool
+    size_t cachedBuffers = 0;
+    size_t cachedBytes = 0;
+};
+
+// cv::MatAllocator that recycles buffers by exact byte size. A Mat created
+// with usePool() takes its buffer from here, and the buffer comes back when
+// the last Mat referring to it is released, wherever that happens. Frame-
+// and face-sized buffers repeat every frame, so after warm-up the pipeline
+// stops touching the heap for them.
+class MatPool : public cv::MatAllocator {
+public:
+    // Process-wide pool; never destroyed, so Mats may outlive any owner
+    static MatPool& shared();
+
+    // Make an empty Mat allocate from the pool on its next create()
+    static cv::Mat& usePool(cv::Mat& mat);
+
+    MatPool(size_t maxPerSize = 16, size_t maxCachedBytes = 256 << 20);
+
+    MatPoolStats stats() const;
+
+    // Give every parked buffer back to the heap
+    void trim();
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+private:
+    size_t maxPerSize;
+    size_t maxCachedBytes;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<size_t, std::vector<uchar*>> freeLists;
+    mutable size_t cachedBuffers;
+    mutable size_t cachedBytes;
+
+    mutable std::atomic<uint64_t> allocations;
+    mutable std::atomic<uint64_t> reuses;
+    mutable std::atomic<uint64_t> frees;
+
+    uchar* acquire(size_t bytes) const;
+    void release(uchar* buffer, size_t bytes) const;
+};
+
+#endif // MAT_POOL_HPP
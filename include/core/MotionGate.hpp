@@ -0,0 +1,50 @@
+#ifndef MOTION_GATE_HPP
+#define MOTION_GATE_HPP
+
+#include <opencv2/opencv.hpp>
+
+struct MotionGateConfig {
+    bool enabled = true;
+    // Width of the downsampled frame the comparison runs on
+    int analysisWidth = 160;
+    // Gray-level change for a pixel to count as moving
+    double pixelThreshold = 25.0;
+    // Fraction of moving pixels that counts as a change; lower is more sensitive
+    double changedFraction = 0.005;
+    // Learning rate of the running background
+    double backgroundRate = 0.05;
+    // Force a detection after this many skipped frames
+    int refreshInterval = 30;
+};
+
+// Cheap change detector placed in front of face detection. Each frame is
+// compared, at low resolution, against a running average of recent frames;
+// if too few pixels changed, detection can be skipped and the previous
+// faces reused.
+class MotionGate {
+public:
+    explicit MotionGate(const MotionGateConfig& config = MotionGateConfig());
+    ~MotionGate() = default;
+
+    // Whether this frame differs enough from the background to detect on
+    bool shouldDetect(const cv::Mat& frame);
+
+    // Forget the background, e.g. when the video source changes
+    void reset();
+
+    void setConfig(const MotionGateConfig& config);
+
+    // Map a 0-100 sensitivity onto changedFraction
+    static double fractionForSensitivity(int sensitivity);
+
+private:
+    MotionGateConfig config;
+    cv::Mat background;
+    cv::Mat small;
+    cv::Mat smallColor;
+    cv::Mat reference;
+    cv::Mat difference;
+    int sinceDetection;
+};
+
+#endif // MOTION_GATE_HPP
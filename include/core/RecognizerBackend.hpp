@@ -0,0 +1,82 @@
+#ifndef RECOGNIZER_BACKEND_HPP
+#define RECOGNIZER_BACKEND_HPP
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GalleryFile.hpp"
+#include "HistogramMatcher.hpp"
+
+// Values are stored in gallery headers; append new backends at the end
+enum class RecognizerType {
+    // Local binary pattern histograms; the long-standing default
+    Lbph,
+    // PCA subspace learned from the enrolled faces
+    Eigenfaces,
+    // LDA subspace learned from the enrolled faces; needs two identities
+    Fisherfaces,
+    // SFace CNN embedding through cv::dnn
+    SFace
+};
+
+// One way of turning a face crop into a descriptor row for the gallery.
+// Backends are shared between recognition threads, so preprocess() and
+// describe() must be safe to call concurrently. train() and read() change
+// the model and only run while nothing is being recognized.
+class RecognizerBackend {
+public:
+    virtual ~RecognizerBackend() = default;
+
+    virtual RecognizerType type() const = 0;
+
+    // Normalize a BGR crop into what describe() takes. This is also what
+    // the journal stores, so it must not depend on trained state.
+    virtual cv::Mat preprocess(const cv::Mat& faceImage) const = 0;
+
+    // Descriptor of a preprocessed face as a single CV_32F row, or an empty
+    // Mat while the backend has no model to describe with
+    virtual cv::Mat describe(const cv::Mat& processed) const = 0;
+
+    // Distance the matcher compares descriptors with
+    virtual HistogramMatcher::Metric metric() const = 0;
+
+    // Distance at which a match stops being accepted. Confidence values are
+    // scaled so that this maps to 100 for every backend, as it is for LBPH.
+    virtual double acceptDistance() const = 0;
+
+    // Subspace backends learn the projection from the gallery itself and
+    // must be trained again whenever the samples change
+    virtual bool isTrainable() const { return false; }
+    virtual bool train(const std::vector<cv::Mat>&, const std::vector<int>&) { return true; }
+
+    // Model state kept in YAML snapshots next to the gallery rows
+    virtual void write(cv::FileStorage&) const {}
+    virtual bool read(const cv::FileNode&) { return true; }
+
+    // Parameters kept in binary gallery headers
+    virtual GalleryParams galleryParams() const;
+    virtual void setGalleryParams(const GalleryParams&) {}
+
+    // Create a backend. modelFile is only used by network backends; empty
+    // selects the bundled model under data/. Returns null if it cannot be
+    // loaded.
+    static std::shared_ptr<RecognizerBackend> create(RecognizerType type,
+                                                     const std::string& modelFile = std::string());
+
+    // Network weights, empty for the classical backends
+    static const char* defaultModelFile(RecognizerType type);
+
+    // Every backend keeps its own snapshot and journal, since descriptors
+    // of one cannot be matched by another
+    static const char* defaultGalleryFile(RecognizerType type);
+    static const char* defaultJournalFile(RecognizerType type);
+
+    // Short names used in settings and on the command line
+    // ("lbph", "eigenfaces", "fisherfaces", "sface")
+    static const char* typeName(RecognizerType type);
+    static bool parseType(const std::string& name, RecognizerType& type);
+    static std::vector<RecognizerType> allTypes();
+};
+
+#endif // RECOGNIZER_BACKEND_HPP
@@ -0,0 +1,39 @@
+#ifndef SFACE_BACKEND_HPP
+#define SFACE_BACKEND_HPP
+
+#include <opencv2/dnn.hpp>
+#include <string>
+#include "InstancePool.hpp"
+#include "RecognizerBackend.hpp"
+
+// SFace CNN run on the CPU through OpenCV's dnn module. Each face becomes
+// a 128-value unit-length embedding compared with cosine distance, which
+// stays reliable across lighting and pose far better than LBPH. Crops come
+// from the detector without landmark alignment, so the acceptance distance
+// is the one SFace publishes for aligned faces and may need tightening.
+// Networks keep their input blobs between calls, so every concurrent
+// caller gets its own instance loaded from the same file.
+class SFaceBackend : public RecognizerBackend {
+public:
+    SFaceBackend();
+
+    // Load the network and run it once; false if it cannot be loaded
+    bool load(const std::string& modelFile);
+
+    RecognizerType type() const override;
+
+    // 112x112 BGR, the input size of the network
+    cv::Mat preprocess(const cv::Mat& faceImage) const override;
+    cv::Mat describe(const cv::Mat& processed) const override;
+    HistogramMatcher::Metric metric() const override;
+    double acceptDistance() const override;
+
+private:
+    std::string modelFile;
+    mutable InstancePool<cv::dnn::Net> networks;
+
+    std::unique_ptr<cv::dnn::Net> createNetwork() const;
+    static cv::Mat embed(cv::dnn::Net& network, const cv::Mat& processed);
+};
+
+#endif // SFACE_BACKEND_HPP
@@ -0,0 +1,87 @@
+#ifndef STREAM_MANAGER_HPP
+#define STREAM_MANAGER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FaceDetector.hpp"
+#include "FaceRecognizer.hpp"
+#include "FramePipeline.hpp"
+
+struct StreamOptions {
+    // Camera indices ("0", "1", ...), video files or stream URLs
+    std::vector<std::string> sources = {"0"};
+    std::string cascadeFile = "data/haarcascade_frontalface_default.xml";
+    // Already loaded detector backend to use instead of reading cascadeFile
+    std::shared_ptr<DetectorBackend> detector;
+    // Detector settings applied to every stream
+    int minFaceSize = 30;
+    bool coarseToFine = false;
+    // Template for each stream's pipeline; source and firstCore are set per stream
+    PipelineConfig pipeline;
+};
+
+// Per-stream counters, sampled while the streams run
+struct StreamStats {
+    std::string source;
+    bool running = false;
+    uint64_t frames = 0;
+    uint64_t droppedFrames = 0;
+    uint64_t recognizerCalls = 0;
+    uint64_t skippedDetections = 0;
+    // Faces passed or kept from the recognizer by the quality gate
+    FaceQualityStats faceQuality;
+    // Identities committed by voting
+    uint64_t identityCommits = 0;
+    // Mean time the detector spent per frame
+    double detectMs = 0.0;
+};
+
+// Runs one FramePipeline per capture source. Every stream has its own
+// detector settings and worker threads; all of them share one detector backend
+// and one recognizer, which they only read, so the models are held once
+// however many cameras run.
+class StreamManager {
+public:
+    // Called on the stream's present thread
+    using ResultCallback = std::function<void(size_t stream, FrameResult&&)>;
+    // Called on the stream's present thread when it stops delivering frames;
+    // isRunning() already reflects the stream as stopped
+    using FinishedCallback = std::function<void(size_t stream)>;
+
+    explicit StreamManager(FaceRecognizer& recognizer);
+    ~StreamManager();
+
+    StreamManager(const StreamManager&) = delete;
+    StreamManager& operator=(const StreamManager&) = delete;
+
+    // Open every source and start its pipeline. Sources that fail to open
+    // are left stopped; returns false only if none could be started.
+    bool start(const StreamOptions& options, ResultCallback onResult, FinishedCallback onFinished = nullptr);
+
+    // Stop every stream and wait for its stages to finish
+    void stop();
+
+    // True while at least one stream runs
+    bool isRunning() const;
+
+    // Streams from the last start(), including those that failed to open
+    size_t streamCount() const;
+    StreamStats stats(size_t stream) const;
+
+private:
+    struct Stream {
+        std::string source;
+        FaceDetector detector;
+        FramePipeline pipeline;
+
+        explicit Stream(FaceRecognizer& recognizer) : pipeline(detector, recognizer) {}
+    };
+
+    FaceRecognizer& recognizer;
+    std::vector<std::unique_ptr<Stream>> streams;
+};
+
+#endif // STREAM_MANAGER_HPP
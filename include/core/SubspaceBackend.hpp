@@ -0,0 +1,39 @@
+#ifndef SUBSPACE_BACKEND_HPP
+#define SUBSPACE_BACKEND_HPP
+
+#include <opencv2/face.hpp>
+#include "RecognizerBackend.hpp"
+
+// Eigenfaces (PCA) or Fisherfaces (LDA) over 100x100 equalized gray
+// faces. The projection is learned from the gallery, so every change to
+// the samples means training again; faces are then described by their
+// coordinates in the subspace and compared with Euclidean distance, as
+// BasicFaceRecognizer::predict does.
+class SubspaceBackend : public RecognizerBackend {
+public:
+    // type must be Eigenfaces or Fisherfaces
+    explicit SubspaceBackend(RecognizerType type);
+
+    RecognizerType type() const override;
+    cv::Mat preprocess(const cv::Mat& faceImage) const override;
+    cv::Mat describe(const cv::Mat& processed) const override;
+    HistogramMatcher::Metric metric() const override;
+    double acceptDistance() const override;
+
+    bool isTrainable() const override;
+    bool train(const std::vector<cv::Mat>& processed, const std::vector<int>& labels) override;
+
+    void write(cv::FileStorage& fs) const override;
+    bool read(const cv::FileNode& node) override;
+
+private:
+    RecognizerType subspaceType;
+    cv::Ptr<cv::face::BasicFaceRecognizer> model;
+    // Copied out of the model after training, empty until then
+    cv::Mat eigenvectors;
+    cv::Mat mean;
+
+    cv::Ptr<cv::face::BasicFaceRecognizer> createModel() const;
+};
+
+#endif // SUBSPACE_BACKEND_HPP
@@ -1,27 +1,106 @@
 #ifndef VOICE_GREETER_HPP
 #define VOICE_GREETER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
+#include "GreetingCache.hpp"
 
+// Greeting counters since initialize()
+struct GreeterStats {
+    uint64_t spoken = 0;
+    // Spoken from pre-rendered audio, without synthesis
+    uint64_t cacheHits = 0;
+    // Requests for a name that was already waiting or being spoken
+    uint64_t merged = 0;
+    // Greetings pushed out of a full queue or too old to still be useful
+    uint64_t dropped = 0;
+};
+
+// Speaks greetings through the espeak library on a dedicated audio thread,
+// so greet() only queues a name and returns; the caller, usually the GUI
+// thread, never waits for synthesis or playback. The queue is short: at
+// rush hour a late greeting is worse than none, so a full queue drops its
+// oldest entry and entries that waited too long are skipped.
+//
+// Where ALSA is available greetings are rendered to PCM once per name and
+// voice, ahead of time when possible, and played from a GreetingCache, so
+// a check-in costs no synthesis. Without it espeak plays each greeting.
 class VoiceGreeter {
 public:
-    VoiceGreeter();
-    ~VoiceGreeter() = default;
+    explicit VoiceGreeter(size_t queueCapacity = 4,
+                          std::chrono::milliseconds maxDelay = std::chrono::seconds(5));
+    // Drops queued greetings and waits for the one being spoken
+    ~VoiceGreeter();
 
-    // Initialize the voice system
+    // Start the audio thread and load espeak on it; false if espeak
+    // cannot be initialized
     bool initialize();
     
-    // Greet a person by name
+    // Queue a greeting for a person by name
     void greet(const std::string& name);
     
-    // Set voice parameters
+    // Render greetings for these names in the background while the audio
+    // thread is idle, e.g. every enrolled person at startup
+    void prepare(const std::vector<std::string>& names);
+    
+    // Set voice parameters; applied from the next greeting on. A change
+    // discards every rendered greeting and renders the known names again.
     void setVoiceSpeed(int speed);
     void setVoicePitch(int pitch);
 
+    GreeterStats getStats() const;
+
 private:
-    int speed;
-    int pitch;
+    struct Pending {
+        std::string name;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    std::atomic<int> speed;
+    std::atomic<int> pitch;
     bool initialized;
+    size_t capacity;
+    std::chrono::milliseconds maxDelay;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Pending> queue;
+    // Names to render while idle
+    std::deque<std::string> renders;
+    // Every name prepared or greeted, rendered again after a voice change
+    std::set<std::string> knownNames;
+    // Name being spoken right now, empty while idle
+    std::string speaking;
+    bool stopping;
+    bool voiceChanged;
+    // Set by the audio thread once it plays PCM itself
+    std::atomic<bool> caching;
+    GreeterStats stats;
+    // Only used on the audio thread
+    GreetingCache cache;
+    int sampleRate;
+    std::thread audioThread;
+
+    // Audio thread: every espeak call happens here
+    void run(std::promise<bool> ready);
+
+    // Synthesize a greeting to PCM with the current voice
+    std::shared_ptr<const GreetingClip> render(const std::string& name);
+
+    // Cached clip, rendered and stored first if needed
+    std::shared_ptr<const GreetingClip> clipFor(const std::string& name, bool& cached);
+
+    void changeVoice();
 
     // Generate greeting message
     std::string generateGreeting(const std::string& name);
@@ -0,0 +1,48 @@
+#ifndef ATTENDANCE_TABLE_MODEL_HPP
+#define ATTENDANCE_TABLE_MODEL_HPP
+
+#include <QAbstractTableModel>
+#include <vector>
+#include "../core/AttendanceLogger.hpp"
+
+// Table model that reads rows straight from the logger's storage. Rows are
+// exposed to the view in batches through fetchMore(), cell text is only
+// built for rows the view paints, and new check-ins are announced as
+// appended rows instead of a full reset.
+class AttendanceTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit AttendanceTableModel(const AttendanceLogger& logger, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Show every record in log order
+    void showAll();
+    
+    // Show only the records of a query
+    void showView(const RecordView& view);
+    
+    // The logger has new records at the end
+    void recordsAppended();
+    
+    // Rows in the current selection, including ones not fetched yet
+    int matchCount() const;
+
+private:
+    const AttendanceLogger& logger;
+    bool filtered;
+    // Record positions when showing a query result
+    std::vector<size_t> positions;
+    int totalRows;
+    int fetchedRows;
+
+    const AttendanceRecord& recordAt(int row) const;
+};
+
+#endif // ATTENDANCE_TABLE_MODEL_HPP
@@ -0,0 +1,21 @@
+#ifndef IMAGE_CONVERSION_HPP
+#define IMAGE_CONVERSION_HPP
+
+#include <QImage>
+#include <QSize>
+#include <opencv2/opencv.hpp>
+
+// Convert a BGR or grayscale frame into a QImage that owns its pixels
+QImage matToQImage(const cv::Mat& mat);
+
+// Read-only QImage over the frame's own buffer, which it keeps alive.
+// BGR frames are wrapped as-is on Qt 5.14 and later; older Qt needs one
+// BGR->RGB conversion. Returns a null image for other pixel types.
+QImage wrapMat(const cv::Mat& mat);
+
+// Shrink a frame to fit size, keeping its aspect ratio, and wrap the
+// result. Meant to run on a worker thread so the GUI thread only paints.
+// Frames that already fit are wrapped without scaling.
+QImage scaledFrameImage(const cv::Mat& frame, const QSize& size);
+
+#endif // IMAGE_CONVERSION_HPP
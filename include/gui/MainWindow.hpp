@@ -4,24 +4,34 @@
 #include <QMainWindow>
 #include <QLabel>
 #include <QPushButton>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTimer>
 #include <QStatusBar>
 #include <QThread>
 #include <QApplication>
 #include <QComboBox>
 #include <QSlider>
+#include <QSpinBox>
 #include <QCheckBox>
 #include <QTabWidget>
 #include <QDateEdit>
 #include <QLineEdit>
 #include <QProgressBar>
 #include <QGroupBox>
+#include <QGridLayout>
 #include <opencv2/opencv.hpp>
 #include "../core/FaceDetector.hpp"
 #include "../core/FaceRecognizer.hpp"
 #include "../core/AttendanceLogger.hpp"
 #include "../core/VoiceGreeter.hpp"
+#include "../core/FramePipeline.hpp"
+#include "../core/StreamManager.hpp"
+#include "../core/EnrollmentSession.hpp"
+#include "AttendanceTableModel.hpp"
+#include "VideoWidget.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -34,9 +44,9 @@ private slots:
     void startRecognition();
     void stopRecognition();
     void registerNewFace();
+    void removePerson();
     void exportAttendance();
     void clearLog();
-    void updateFrame();
     void updateAttendanceTable();
     void searchAttendance();
     void filterByDate();
@@ -50,7 +60,7 @@ private:
     
     // Recognition Tab
     QWidget* recognitionTab;
-    QLabel* cameraFeed;
+    QGridLayout* cameraGrid;
     QPushButton* startButton;
     QProgressBar* confidenceBar;
     QLabel* currentPersonLabel;
@@ -64,10 +74,12 @@ private:
     QLineEdit* nameInput;
     QPushButton* captureButton;
     QProgressBar* captureProgress;
+    QPushButton* removeButton;
     
     // Attendance Tab
     QWidget* attendanceTab;
-    QTableWidget* attendanceTable;
+    QTableView* attendanceTable;
+    AttendanceTableModel* attendanceModel;
     QPushButton* exportButton;
     QPushButton* clearButton;
     QLineEdit* searchBox;
@@ -83,11 +95,22 @@ private:
     QComboBox* recognizerTypeCombo;
     QSlider* confidenceThresholdSlider;
     QCheckBox* autoSaveCheckbox;
+    QCheckBox* approximateSearchCheckbox;
+    QComboBox* detectorTypeCombo;
+    QSpinBox* minFaceSizeSpin;
+    QCheckBox* coarseToFineCheckbox;
+    QCheckBox* motionGateCheckbox;
+    QSlider* motionSensitivitySlider;
+    QCheckBox* qualityGateCheckbox;
+    QSpinBox* minRecognizeSizeSpin;
+    QLineEdit* cameraSourcesInput;
     QPushButton* saveSettingsButton;
     
-    // Status and timer
+    // Status bar
     QStatusBar* statusBar;
-    QTimer* timer;
+    
+    // Syncs journaled check-ins that are due
+    QTimer* journalTimer;
 
     // Core Components
     FaceDetector faceDetector;
@@ -95,8 +118,21 @@ private:
     AttendanceLogger attendanceLogger;
     VoiceGreeter voiceGreeter;
 
-    // Video capture
-    cv::VideoCapture capture;
+    // One capture/detect/recognize/present pipeline per camera
+    StreamManager streams;
+    
+    // Video tile of one stream
+    struct StreamView {
+        VideoWidget* feed = nullptr;
+        // Set while a converted frame waits for the GUI thread
+        std::atomic<bool> displayPending{false};
+    };
+    std::vector<std::unique_ptr<StreamView>> streamViews;
+
+    // Background capture for registration
+    EnrollmentSession enrollment;
+    // Set while a preview frame waits for the GUI thread
+    std::atomic<bool> enrollmentPreviewPending{false};
     bool isCapturing;
     int recognitionCount;
     int totalDetections;
@@ -111,11 +147,15 @@ private:
     void initializeComponents();
     void saveSettings();
     void loadSettings();
+    void applyDetectorSettings();
 
     // Helper functions
     void showMessage(const QString& message);
-    QImage matToQImage(const cv::Mat& mat);
     void updateStats();
+    void setupCameraFeeds(size_t count);
+    void updateFrame(size_t stream, const QImage& image, const QSize& frameSize, const std::vector<FaceResult>& faces);
+    void showRecords(const RecordView& records);
+    void finishEnrollment(const QString& name, const EnrollmentResult& result);
     void playGreeting(const std::string& name);
 };
 
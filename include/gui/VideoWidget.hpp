@@ -0,0 +1,42 @@
+#ifndef VIDEO_WIDGET_HPP
+#define VIDEO_WIDGET_HPP
+
+#include <QWidget>
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <vector>
+#include "../core/FramePipeline.hpp"
+
+// Shows one camera stream. Frames arrive already scaled by the worker and
+// are painted as they are; face boxes and names are drawn over them with
+// QPainter in widget coordinates, so frame pixels are never modified.
+class VideoWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit VideoWidget(QWidget* parent = nullptr);
+
+    // Show a frame and its faces. originalSize is the size of the frame
+    // the face boxes refer to, before any scaling.
+    void setFrame(const QImage& frame, const QSize& originalSize, const std::vector<FaceResult>& results);
+
+    void clear();
+
+    // Size frames should be scaled to before setFrame(); safe to call from
+    // any thread
+    QSize targetSize() const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    QImage image;
+    QSize frameSize;
+    std::vector<FaceResult> faces;
+    std::atomic<int> targetWidth;
+    std::atomic<int> targetHeight;
+};
+
+#endif // VIDEO_WIDGET_HPP
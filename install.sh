@@ -39,7 +39,8 @@ sudo apt-get install -y \
   qtbase5-dev \
   qt5-qmake \
   espeak \
-  libespeak-dev
+  libespeak-dev \
+  libasound2-dev
 
 # Create installation directory
 sudo mkdir -p $INSTALL_DIR
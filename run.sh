@@ -78,6 +78,29 @@ else
   fi
 fi
 
+# Optional detector models (Settings -> Face Detector); missing ones only
+# disable that detector
+echo -e "${BLUE}Checking for optional detector models...${NC}"
+OPTIONAL_MODELS=(
+  "lbpcascade_frontalface_improved.xml https://raw.githubusercontent.com/opencv/opencv/master/data/lbpcascades/lbpcascade_frontalface_improved.xml"
+  "face_detection_yunet_2023mar.onnx https://github.com/opencv/opencv_zoo/raw/main/models/face_detection_yunet/face_detection_yunet_2023mar.onnx"
+  "deploy.prototxt https://raw.githubusercontent.com/opencv/opencv/master/samples/dnn/face_detector/deploy.prototxt"
+  "res10_300x300_ssd_iter_140000.caffemodel https://raw.githubusercontent.com/opencv/opencv_3rdparty/dnn_samples_face_detector_20170830/res10_300x300_ssd_iter_140000.caffemodel"
+  "face_recognition_sface_2021dec.onnx https://github.com/opencv/opencv_zoo/raw/main/models/face_recognition_sface/face_recognition_sface_2021dec.onnx"
+)
+for entry in "${OPTIONAL_MODELS[@]}"; do
+  model=${entry%% *}
+  url=${entry#* }
+  if [ -f "data/$model" ]; then
+    cp "data/$model" build/data/
+  elif wget -q -P build/data/ "$url"; then
+    cp "build/data/$model" data/
+    echo -e "${GREEN}✓ Downloaded $model.${NC}"
+  else
+    echo -e "${YELLOW}Warning: could not download $model; that detector or recognizer will be unavailable.${NC}"
+  fi
+done
+
 # Go to build directory
 cd build
 
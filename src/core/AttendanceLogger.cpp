@@ -1,13 +1,65 @@
 #include "../../include/core/AttendanceLogger.hpp"
+#include "../../include/core/FileSync.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 
-AttendanceLogger::AttendanceLogger(const std::string& logFile) : logFile(logFile) {
+namespace {
+
+// Split a "name,date,time" line; false if a field is missing
+bool parseRecord(const std::string& line, AttendanceRecord& record) {
+    size_t first = line.find(',');
+    if (first == std::string::npos) return false;
+    size_t second = line.find(',', first + 1);
+    if (second == std::string::npos) return false;
+    size_t third = line.find(',', second + 1);
+    
+    record.name = line.substr(0, first);
+    record.date = line.substr(first + 1, second - first - 1);
+    record.time = line.substr(second + 1, third == std::string::npos ? std::string::npos : third - second - 1);
+    if (!record.time.empty() && record.time.back() == '\r') {
+        record.time.pop_back();
+    }
+    return true;
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool sameRecord(const AttendanceRecord& a, const AttendanceRecord& b) {
+    return a.name == b.name && a.date == b.date && a.time == b.time;
+}
+
+} // namespace
+
+AttendanceLogger::AttendanceLogger(const std::string& logFile)
+    : logFile(logFile),
+      journalFile(logFile + ".journal"),
+      journal(nullptr),
+      journalRecords(0),
+      unsyncedRecords(0) {
     loadRecords();
 }
 
+AttendanceLogger::~AttendanceLogger() {
+    // Leave a complete CSV behind on a clean shutdown
+    if (journalRecords > 0) {
+        compact();
+    }
+    if (journal) {
+        syncFile(journal);
+        std::fclose(journal);
+    }
+}
+
 bool AttendanceLogger::logAttendance(const std::string& name) {
     if (isAlreadyMarked(name)) {
         return false;
@@ -18,36 +70,85 @@ bool AttendanceLogger::logAttendance(const std::string& name) {
     record.date = getCurrentDate();
     record.time = getCurrentTime();
     
+    // Journal first: a check-in that did not reach the file is neither
+    // listed nor counted as marked, so the next sighting tries again
+    if (!appendToJournal(record)) {
+        return false;
+    }
+    
     records.push_back(record);
+    indexRecord(records.size() - 1);
     lastMarked[name] = std::chrono::system_clock::now();
     
-    return saveRecords();
+    if (journalRecords >= policy.compactThreshold) {
+        compact();
+    }
+    return true;
 }
 
 bool AttendanceLogger::exportToCSV(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    file << "Name,Date,Time\n";
-    for (const auto& record : records) {
-        file << record.name << "," << record.date << "," << record.time << "\n";
-    }
-    
-    return true;
+    return writeCSV(filename, false);
 }
 
 void AttendanceLogger::clearLog() {
     records.clear();
     lastMarked.clear();
-    saveRecords();
+    rebuildIndexes();
+    compact();
 }
 
 std::vector<AttendanceRecord> AttendanceLogger::getRecords() const {
     return records;
 }
 
+const std::vector<AttendanceRecord>& AttendanceLogger::allRecords() const {
+    return records;
+}
+
+RecordView AttendanceLogger::recordsOn(const std::string& date) const {
+    RecordView view = makeView();
+    auto it = dateIndex.find(date);
+    if (it != dateIndex.end()) {
+        view.segments.push_back(&it->second);
+    }
+    return view;
+}
+
+RecordView AttendanceLogger::recordsBetween(const std::string& fromDate, const std::string& toDate) const {
+    // ISO dates sort lexicographically, so the map order is date order
+    RecordView view = makeView();
+    for (auto it = dateIndex.lower_bound(fromDate); it != dateIndex.end() && it->first <= toDate; ++it) {
+        view.segments.push_back(&it->second);
+    }
+    return view;
+}
+
+RecordView AttendanceLogger::recordsFor(const std::string& name) const {
+    RecordView view = makeView();
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end()) {
+        view.segments.push_back(&it->second);
+    }
+    return view;
+}
+
+RecordView AttendanceLogger::recordsMatching(const std::string& prefix) const {
+    std::string key = toLower(prefix);
+    
+    // Several words of one name can match; list each name once
+    std::set<std::string> names;
+    for (auto it = wordIndex.lower_bound(key);
+         it != wordIndex.end() && it->first.compare(0, key.size(), key) == 0; ++it) {
+        names.insert(it->second.begin(), it->second.end());
+    }
+    
+    RecordView view = makeView();
+    for (const auto& name : names) {
+        view.segments.push_back(&nameIndex.at(name));
+    }
+    return view;
+}
+
 bool AttendanceLogger::isAlreadyMarked(const std::string& name) const {
     auto it = lastMarked.find(name);
     if (it == lastMarked.end()) {
@@ -59,33 +160,200 @@ bool AttendanceLogger::isAlreadyMarked(const std::string& name) const {
     return duration.count() < 24;
 }
 
-bool AttendanceLogger::loadRecords() {
-    std::ifstream file(logFile);
-    if (!file.is_open()) {
+void AttendanceLogger::setCommitPolicy(const CommitPolicy& policy) {
+    this->policy = policy;
+    this->policy.syncBatch = std::max<size_t>(1, policy.syncBatch);
+}
+
+bool AttendanceLogger::flush() {
+    if (!journal) {
+        return false;
+    }
+    if (unsyncedRecords == 0) {
+        return true;
+    }
+    
+    unsyncedRecords = 0;
+    return syncFile(journal);
+}
+
+bool AttendanceLogger::flushIfDue() {
+    if (unsyncedRecords == 0 || std::chrono::steady_clock::now() - oldestUnsynced < policy.syncInterval) {
+        return true;
+    }
+    return flush();
+}
+
+bool AttendanceLogger::compact() {
+    // Write the new snapshot beside the old one and swap it in atomically,
+    // so a crash leaves either the old or the new CSV, never a partial one
+    std::string tempFile = logFile + ".tmp";
+    if (!writeCSV(tempFile, true)) {
+        return false;
+    }
+    
+    if (!replaceFile(tempFile, logFile)) {
         return false;
     }
     
+    // A crash before this point is caught by loadRecords(), which skips a
+    // journal that already matches the tail of the CSV
+    return openJournal(true);
+}
+
+bool AttendanceLogger::loadRecords() {
     records.clear();
-    std::string line;
-    // Skip header
-    std::getline(file, line);
+    bool loaded = false;
     
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
+    std::ifstream file(logFile);
+    if (file.is_open()) {
+        loaded = true;
+        std::string line;
+        // Skip header
+        std::getline(file, line);
+        
         AttendanceRecord record;
+        while (std::getline(file, line)) {
+            if (parseRecord(line, record)) {
+                records.push_back(record);
+            }
+        }
+    }
+    
+    // Replay check-ins journaled since the last compaction. Only lines that
+    // end in a newline were fully written; a torn tail is cut off.
+    std::vector<AttendanceRecord> journaled;
+    std::ifstream journalIn(journalFile, std::ios::binary);
+    if (journalIn.is_open()) {
+        std::string contents((std::istreambuf_iterator<char>(journalIn)), std::istreambuf_iterator<char>());
+        journalIn.close();
         
-        std::getline(ss, record.name, ',');
-        std::getline(ss, record.date, ',');
-        std::getline(ss, record.time, ',');
+        size_t start = 0;
+        size_t end;
+        AttendanceRecord record;
+        while ((end = contents.find('\n', start)) != std::string::npos) {
+            if (parseRecord(contents.substr(start, end - start), record)) {
+                journaled.push_back(record);
+            }
+            start = end + 1;
+        }
         
-        records.push_back(record);
+        if (start < contents.size()) {
+            std::error_code error;
+            std::filesystem::resize_file(journalFile, start, error);
+        }
+    }
+    
+    bool alreadyCompacted = !journaled.empty() && journaled.size() <= records.size() &&
+        std::equal(journaled.begin(), journaled.end(), records.end() - journaled.size(), sameRecord);
+    
+    if (alreadyCompacted || journaled.empty()) {
+        openJournal(alreadyCompacted);
+    } else {
+        records.insert(records.end(), journaled.begin(), journaled.end());
+        openJournal(false);
+        journalRecords = journaled.size();
+        loaded = true;
+    }
+    
+    rebuildIndexes();
+    return loaded;
+}
+
+void AttendanceLogger::indexRecord(size_t index) {
+    const AttendanceRecord& record = records[index];
+    dateIndex[record.date].push_back(index);
+    
+    std::vector<size_t>& positions = nameIndex[record.name];
+    positions.push_back(index);
+    if (positions.size() > 1) {
+        return;
+    }
+    
+    // First sighting of this name: index the whole name and each word
+    std::string lowered = toLower(record.name);
+    wordIndex[lowered].insert(record.name);
+    
+    size_t start = 0;
+    while (start < lowered.size()) {
+        size_t end = lowered.find(' ', start);
+        if (end == std::string::npos) end = lowered.size();
+        if (end > start && start > 0) {
+            wordIndex[lowered.substr(start, end - start)].insert(record.name);
+        }
+        start = end + 1;
+    }
+}
+
+void AttendanceLogger::rebuildIndexes() {
+    dateIndex.clear();
+    nameIndex.clear();
+    wordIndex.clear();
+    for (size_t i = 0; i < records.size(); ++i) {
+        indexRecord(i);
+    }
+}
+
+RecordView AttendanceLogger::makeView() const {
+    RecordView view;
+    view.records = &records;
+    return view;
+}
+
+bool AttendanceLogger::appendToJournal(const AttendanceRecord& record) {
+    if (!journal && !openJournal(false)) {
+        return false;
+    }
+    
+    // One line per check-in, handed to the OS immediately so it survives a
+    // process crash; fsync is batched across check-ins (group commit)
+    std::string line = record.name + "," + record.date + "," + record.time + "\n";
+    if (std::fwrite(line.data(), 1, line.size(), journal) != line.size() || std::fflush(journal) != 0) {
+        return false;
     }
     
+    auto now = std::chrono::steady_clock::now();
+    if (unsyncedRecords == 0) {
+        oldestUnsynced = now;
+    }
+    journalRecords++;
+    unsyncedRecords++;
+    
+    if (unsyncedRecords >= policy.syncBatch || now - oldestUnsynced >= policy.syncInterval) {
+        return flush();
+    }
     return true;
 }
 
-bool AttendanceLogger::saveRecords() {
-    return exportToCSV(logFile);
+bool AttendanceLogger::openJournal(bool truncate) {
+    if (journal) {
+        std::fclose(journal);
+    }
+    
+    journal = std::fopen(journalFile.c_str(), truncate ? "wb" : "ab");
+    unsyncedRecords = 0;
+    if (truncate) {
+        journalRecords = 0;
+    }
+    return journal != nullptr;
+}
+
+bool AttendanceLogger::writeCSV(const std::string& filename, bool sync) const {
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    
+    bool ok = std::fputs("Name,Date,Time\n", file) >= 0;
+    for (const auto& record : records) {
+        if (!ok) break;
+        ok = std::fprintf(file, "%s,%s,%s\n", record.name.c_str(), record.date.c_str(), record.time.c_str()) >= 0;
+    }
+    
+    if (ok && sync) {
+        ok = syncFile(file);
+    }
+    return std::fclose(file) == 0 && ok;
 }
 
 std::string AttendanceLogger::getCurrentDate() const {
@@ -102,4 +370,4 @@ std::string AttendanceLogger::getCurrentTime() const {
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time), "%H:%M:%S");
     return ss.str();
-} 
\ No newline at end of file
+}
@@ -0,0 +1,274 @@
+#include "../../include/core/BatchProcessor.hpp"
+#include "../../include/core/FaceDetector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+BatchProcessor::BatchProcessor(FaceRecognizer& recognizer, const BatchOptions& options)
+    : recognizer(recognizer), options(options) {
+    this->options.frameStride = std::max(1, options.frameStride);
+    this->options.segmentFrames = std::max(1, options.segmentFrames);
+}
+
+bool BatchProcessor::run(EventCallback onEvent, StatsCallback onStats) {
+    // One detector for every worker; each detect() call leases its own
+    // classifier or network, so the model is loaded once however many
+    // threads run
+    FaceDetector detector;
+    if (!detector.initialize(options.detector, options.detectorModel, options.detectorConfig)) {
+        return false;
+    }
+    if (options.minFaceSize > 0) {
+        detector.setMinFaceSize(options.minFaceSize);
+        detector.setCoarseToFine(true);
+    }
+
+    std::vector<WorkUnit> units;
+    std::vector<double> mediaSeconds;
+    bool allOpened = planWork(units, mediaSeconds);
+
+    using Clock = std::chrono::steady_clock;
+    struct InputState {
+        size_t pendingUnits = 0;
+        double detectMs = 0.0;
+        bool started = false;
+        Clock::time_point firstStart;
+        std::map<std::string, AttendanceEvent> firstSeen;
+        BatchFileStats stats;
+    };
+
+    std::vector<InputState> inputs(options.inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i].stats.source = options.inputs[i];
+        inputs[i].stats.mediaSeconds = mediaSeconds[i];
+    }
+    for (const auto& unit : units) {
+        inputs[unit.input].pendingUnits++;
+    }
+
+    unsigned threads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(units.size())));
+
+    // Parallelism comes from the workers; keep OpenCV from oversubscribing
+    if (threads > 1) {
+        cv::setNumThreads(1);
+    }
+
+    std::atomic<size_t> nextUnit(0);
+    std::mutex mutex;
+
+    auto worker = [&]() {
+        size_t index;
+        while ((index = nextUnit++) < units.size()) {
+            const WorkUnit& unit = units[index];
+            const std::string& source = options.inputs[unit.input];
+            Clock::time_point unitStart = Clock::now();
+
+            std::map<std::string, AttendanceEvent> seen;
+            uint64_t frames = 0;
+            uint64_t faces = 0;
+            double detectMs = 0.0;
+
+            auto processFrame = [&](const cv::Mat& frame, int64_t frameIndex, double seconds) {
+                Detection detection = detector.detect(frame);
+                const std::vector<cv::Rect>& rects = detection.faces;
+                frames++;
+                faces += rects.size();
+                detectMs += detection.milliseconds;
+
+                std::vector<cv::Mat> crops;
+                for (const auto& rect : rects) {
+                    crops.push_back(frame(rect));
+                }
+
+                for (const auto& result : recognizer.recognizeBatch(crops)) {
+                    if (result.name == "Unknown") continue;
+
+                    auto it = seen.find(result.name);
+                    if (it == seen.end() || frameIndex < it->second.frame) {
+                        seen[result.name] = AttendanceEvent{source, frameIndex, seconds, result.name, result.confidence};
+                    }
+                }
+            };
+
+            if (unit.isVideo) {
+                cv::VideoCapture capture(source);
+                bool positioned = unit.begin == 0 || seekToFrame(capture, source, unit.begin);
+
+                cv::Mat frame;
+                for (int64_t f = unit.begin; positioned && (unit.end < 0 || f < unit.end); ++f) {
+                    if (f % options.frameStride != 0) {
+                        // Skipped frames are demuxed but never decoded into a Mat
+                        if (!capture.grab()) break;
+                        continue;
+                    }
+                    if (!capture.read(frame) || frame.empty()) break;
+                    processFrame(frame, f, capture.get(cv::CAP_PROP_POS_MSEC) / 1000.0);
+                }
+            } else {
+                for (size_t i = 0; i < unit.images.size(); ++i) {
+                    cv::Mat frame = cv::imread(unit.images[i]);
+                    if (frame.empty()) continue;
+                    processFrame(frame, unit.begin + static_cast<int64_t>(i), -1.0);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            InputState& state = inputs[unit.input];
+            if (!state.started || unitStart < state.firstStart) {
+                state.firstStart = unitStart;
+                state.started = true;
+            }
+            state.stats.frames += frames;
+            state.stats.faces += faces;
+            state.detectMs += detectMs;
+            for (auto& entry : seen) {
+                auto it = state.firstSeen.find(entry.first);
+                if (it == state.firstSeen.end() || entry.second.frame < it->second.frame) {
+                    state.firstSeen[entry.first] = entry.second;
+                }
+            }
+
+            if (--state.pendingUnits > 0) continue;
+
+            // Last segment of this input: publish its results
+            state.stats.wallSeconds =
+                std::chrono::duration<double>(Clock::now() - state.firstStart).count();
+            state.stats.detectMs = state.stats.frames > 0 ? state.detectMs / state.stats.frames : 0.0;
+
+            std::vector<AttendanceEvent> events;
+            for (const auto& entry : state.firstSeen) {
+                events.push_back(entry.second);
+            }
+            std::sort(events.begin(), events.end(), [](const AttendanceEvent& a, const AttendanceEvent& b) {
+                return a.frame < b.frame;
+            });
+
+            if (onEvent) {
+                for (const auto& event : events) {
+                    onEvent(event);
+                }
+            }
+            if (onStats) {
+                onStats(state.stats);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    return allOpened;
+}
+
+bool BatchProcessor::planWork(std::vector<WorkUnit>& units, std::vector<double>& mediaSeconds) {
+    bool allOpened = true;
+    mediaSeconds.assign(options.inputs.size(), 0.0);
+
+    for (size_t i = 0; i < options.inputs.size(); ++i) {
+        const std::string& input = options.inputs[i];
+        std::error_code error;
+
+        if (fs::is_directory(input, error)) {
+            std::vector<std::string> images;
+            for (const auto& entry : fs::directory_iterator(input, error)) {
+                if (entry.is_regular_file() && isImageFile(entry.path().string())) {
+                    images.push_back(entry.path().string());
+                }
+            }
+            std::sort(images.begin(), images.end());
+
+            if (images.empty()) {
+                allOpened = false;
+                continue;
+            }
+
+            for (size_t begin = 0; begin < images.size(); begin += options.segmentFrames) {
+                size_t end = std::min(images.size(), begin + static_cast<size_t>(options.segmentFrames));
+                WorkUnit unit;
+                unit.input = i;
+                unit.isVideo = false;
+                unit.begin = static_cast<int64_t>(begin);
+                unit.end = static_cast<int64_t>(end);
+                unit.images.assign(images.begin() + begin, images.begin() + end);
+                units.push_back(std::move(unit));
+            }
+            continue;
+        }
+
+        cv::VideoCapture capture(input);
+        if (!capture.isOpened()) {
+            allOpened = false;
+            continue;
+        }
+
+        int64_t frameCount = static_cast<int64_t>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+        double fps = capture.get(cv::CAP_PROP_FPS);
+        if (frameCount > 0 && fps > 0.0) {
+            mediaSeconds[i] = frameCount / fps;
+        }
+
+        if (frameCount <= 0) {
+            // Unknown length (e.g. a stream): process it as one unit
+            WorkUnit unit;
+            unit.input = i;
+            units.push_back(unit);
+            continue;
+        }
+
+        // The frame count is the container's estimate, so the last segment
+        // runs until decoding stops rather than to the estimated end
+        for (int64_t begin = 0; begin < frameCount; begin += options.segmentFrames) {
+            WorkUnit unit;
+            unit.input = i;
+            unit.begin = begin;
+            unit.end = begin + options.segmentFrames < frameCount ? begin + options.segmentFrames : -1;
+            units.push_back(unit);
+        }
+    }
+
+    return allOpened;
+}
+
+bool BatchProcessor::seekToFrame(cv::VideoCapture& capture, const std::string& source, int64_t frame) {
+    // Backends may land on the keyframe before the target, or past it when
+    // the container's index is coarse. Trust only a position at or before
+    // the target and decode forward from there, so segments neither skip
+    // nor repeat frames at their boundaries.
+    int64_t position = -1;
+    if (capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(frame))) {
+        position = static_cast<int64_t>(capture.get(cv::CAP_PROP_POS_FRAMES));
+    }
+    if (position < 0 || position > frame) {
+        if (!capture.open(source)) {
+            return false;
+        }
+        position = 0;
+    }
+
+    for (; position < frame; ++position) {
+        if (!capture.grab()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BatchProcessor::isImageFile(const std::string& path) {
+    std::string extension = fs::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".bmp";
+}
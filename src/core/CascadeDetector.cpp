@@ -0,0 +1,132 @@
+#include "../../include/core/CascadeDetector.hpp"
+#include "../../include/core/MatPool.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+CascadeDetector::CascadeDetector(DetectorType type)
+    : cascadeType(type),
+      classifiers([this]() { return createClassifier(); }) {}
+
+bool CascadeDetector::load(const std::string& file) {
+    std::ifstream input(file, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    cascadeFile = file;
+    cascadeData.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+    // Parse one classifier now so a bad file fails here, and keep it
+    std::unique_ptr<cv::CascadeClassifier> first = createClassifier();
+    if (!first) {
+        return false;
+    }
+    window = first->getOriginalWindowSize();
+    classifiers.add(std::move(first));
+    return true;
+}
+
+DetectorType CascadeDetector::type() const {
+    return cascadeType;
+}
+
+std::vector<cv::Rect> CascadeDetector::detect(const cv::Mat& frame, int minFace, bool coarseToFine) const {
+    std::vector<cv::Rect> faces;
+    InstancePool<cv::CascadeClassifier>::Lease classifier = classifiers.acquire();
+    if (!classifier || frame.empty()) {
+        return faces;
+    }
+
+    // Downscale so the smallest wanted face maps onto the cascade window
+    double scale = window.width > 0 ? static_cast<double>(window.width) / minFace : 1.0;
+
+    if (coarseToFine && scale < 0.9) {
+        detectCoarseToFine(*classifier, frame, minFace, scale, faces);
+    } else {
+        detectFullFrame(*classifier, frame, minFace, faces);
+    }
+    return faces;
+}
+
+size_t CascadeDetector::instances() const {
+    return classifiers.instances();
+}
+
+std::unique_ptr<cv::CascadeClassifier> CascadeDetector::createClassifier() const {
+    auto classifier = std::make_unique<cv::CascadeClassifier>();
+    try {
+        cv::FileStorage storage(cascadeData, cv::FileStorage::READ | cv::FileStorage::MEMORY);
+        if (storage.isOpened()) {
+            classifier->read(storage.getFirstTopLevelNode());
+        }
+    } catch (const cv::Exception&) {
+        // Fall through to loading the file
+    }
+
+    // The legacy Haar format can only be loaded from a file by name
+    if (classifier->empty() && !classifier->load(cascadeFile)) {
+        return nullptr;
+    }
+    return classifier;
+}
+
+void CascadeDetector::detectFullFrame(cv::CascadeClassifier& classifier, const cv::Mat& frame, int minFace,
+                                      std::vector<cv::Rect>& faces) {
+    // Scratch comes from the pool, so same-sized frames reuse the buffer
+    cv::Mat gray;
+    MatPool::usePool(gray);
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::equalizeHist(gray, gray);
+
+    classifier.detectMultiScale(gray, faces,
+        1.1, 3, 0, cv::Size(minFace, minFace));
+}
+
+void CascadeDetector::detectCoarseToFine(cv::CascadeClassifier& classifier, const cv::Mat& frame, int minFace,
+                                         double scale, std::vector<cv::Rect>& faces) {
+    // Resize before the color conversion so both run on the small frame
+    cv::Mat small;
+    cv::Mat gray;
+    cv::Mat regionGray;
+    MatPool::usePool(small);
+    MatPool::usePool(gray);
+    MatPool::usePool(regionGray);
+    cv::resize(frame, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    cv::equalizeHist(gray, gray);
+
+    std::vector<cv::Rect> candidates;
+    classifier.detectMultiScale(gray, candidates, 1.1, 3, 0, classifier.getOriginalWindowSize());
+
+    cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    for (const auto& candidate : candidates) {
+        cv::Rect coarse(cvRound(candidate.x / scale), cvRound(candidate.y / scale),
+            cvRound(candidate.width / scale), cvRound(candidate.height / scale));
+        coarse &= bounds;
+
+        // Search a margin around the candidate at full resolution
+        int margin = coarse.width / 4;
+        cv::Rect region = cv::Rect(coarse.x - margin, coarse.y - margin,
+            coarse.width + 2 * margin, coarse.height + 2 * margin) & bounds;
+
+        cv::cvtColor(frame(region), regionGray, cv::COLOR_BGR2GRAY);
+        cv::equalizeHist(regionGray, regionGray);
+
+        int minSide = std::max(minFace, coarse.width * 2 / 3);
+        int maxSide = coarse.width * 3 / 2;
+        std::vector<cv::Rect> refined;
+        classifier.detectMultiScale(regionGray, refined, 1.1, 3, 0,
+            cv::Size(minSide, minSide), cv::Size(maxSide, maxSide));
+
+        // Only faces the full-resolution pass confirms are reported; the
+        // low-resolution pass alone lets too many false positives through
+        if (refined.empty()) {
+            continue;
+        }
+
+        auto best = std::max_element(refined.begin(), refined.end(),
+            [](const cv::Rect& a, const cv::Rect& b) { return a.area() < b.area(); });
+        faces.push_back(*best + region.tl());
+    }
+}
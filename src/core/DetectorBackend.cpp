@@ -0,0 +1,67 @@
+#include "../../include/core/DetectorBackend.hpp"
+#include "../../include/core/CascadeDetector.hpp"
+#include "../../include/core/DnnDetector.hpp"
+
+std::shared_ptr<DetectorBackend> DetectorBackend::create(DetectorType type, const std::string& modelFile,
+                                                         const std::string& configFile) {
+    std::string model = modelFile.empty() ? defaultModelFile(type) : modelFile;
+    std::string config = configFile.empty() ? defaultConfigFile(type) : configFile;
+
+    switch (type) {
+    case DetectorType::HaarCascade:
+    case DetectorType::LbpCascade: {
+        auto cascade = std::make_shared<CascadeDetector>(type);
+        if (!cascade->load(model)) {
+            return nullptr;
+        }
+        return cascade;
+    }
+    case DetectorType::YuNet:
+    case DetectorType::ResNetSsd: {
+        auto network = std::make_shared<DnnDetector>(type);
+        if (!network->load(model, config)) {
+            return nullptr;
+        }
+        return network;
+    }
+    }
+    return nullptr;
+}
+
+const char* DetectorBackend::defaultModelFile(DetectorType type) {
+    switch (type) {
+    case DetectorType::HaarCascade: return "data/haarcascade_frontalface_default.xml";
+    case DetectorType::LbpCascade: return "data/lbpcascade_frontalface_improved.xml";
+    case DetectorType::YuNet: return "data/face_detection_yunet_2023mar.onnx";
+    case DetectorType::ResNetSsd: return "data/res10_300x300_ssd_iter_140000.caffemodel";
+    }
+    return "";
+}
+
+const char* DetectorBackend::defaultConfigFile(DetectorType type) {
+    return type == DetectorType::ResNetSsd ? "data/deploy.prototxt" : "";
+}
+
+const char* DetectorBackend::typeName(DetectorType type) {
+    switch (type) {
+    case DetectorType::HaarCascade: return "haar";
+    case DetectorType::LbpCascade: return "lbp";
+    case DetectorType::YuNet: return "yunet";
+    case DetectorType::ResNetSsd: return "ssd";
+    }
+    return "";
+}
+
+bool DetectorBackend::parseType(const std::string& name, DetectorType& type) {
+    for (DetectorType candidate : allTypes()) {
+        if (name == typeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<DetectorType> DetectorBackend::allTypes() {
+    return {DetectorType::HaarCascade, DetectorType::LbpCascade, DetectorType::YuNet, DetectorType::ResNetSsd};
+}
@@ -0,0 +1,175 @@
+#include "../../include/core/DnnDetector.hpp"
+#include "../../include/core/MatPool.hpp"
+#include <opencv2/dnn.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/objdetect.hpp>
+#include <algorithm>
+
+// cv::FaceDetectorYN arrived in OpenCV 4.5.4
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || \
+    (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 4)))
+#define FACESECURE_HAVE_YUNET 1
+#endif
+
+namespace {
+
+// Smallest face YuNet finds reliably; coarse-to-fine shrinks the frame
+// until the minimum face is this size
+const double kYuNetMinFace = 20.0;
+
+// Input size and mean the SSD was trained with
+const cv::Size kSsdInput(300, 300);
+const cv::Scalar kSsdMean(104.0, 177.0, 123.0);
+
+} // namespace
+
+struct DnnDetector::Network {
+#ifdef FACESECURE_HAVE_YUNET
+    cv::Ptr<cv::FaceDetectorYN> yunet;
+#endif
+    cv::dnn::Net net;
+};
+
+DnnDetector::DnnDetector(DetectorType type)
+    : networkType(type),
+      scoreThreshold(type == DetectorType::YuNet ? 0.8f : 0.5f),
+      networks([this]() { return createNetwork(); }) {}
+
+DnnDetector::~DnnDetector() = default;
+
+bool DnnDetector::load(const std::string& model, const std::string& config) {
+    modelFile = model;
+    configFile = config;
+
+    std::unique_ptr<Network> first = createNetwork();
+    if (!first) {
+        return false;
+    }
+
+    // One forward pass on a blank frame, so a file that parses but does not
+    // run fails here rather than on the first camera frame
+    try {
+        std::vector<cv::Rect> faces;
+        cv::Mat blank(240, 320, CV_8UC3, cv::Scalar::all(0));
+        if (networkType == DetectorType::YuNet) {
+            detectYuNet(*first, blank, 30, false, faces);
+        } else {
+            detectSsd(*first, blank, 30, faces);
+        }
+    } catch (const cv::Exception&) {
+        return false;
+    }
+
+    networks.add(std::move(first));
+    return true;
+}
+
+DetectorType DnnDetector::type() const {
+    return networkType;
+}
+
+std::vector<cv::Rect> DnnDetector::detect(const cv::Mat& frame, int minFace, bool coarseToFine) const {
+    std::vector<cv::Rect> faces;
+    InstancePool<Network>::Lease network = networks.acquire();
+    if (!network || frame.empty()) {
+        return faces;
+    }
+
+    try {
+        if (networkType == DetectorType::YuNet) {
+            detectYuNet(*network, frame, minFace, coarseToFine, faces);
+        } else {
+            detectSsd(*network, frame, minFace, faces);
+        }
+    } catch (const cv::Exception&) {
+        faces.clear();
+    }
+    return faces;
+}
+
+std::unique_ptr<DnnDetector::Network> DnnDetector::createNetwork() const {
+    auto network = std::make_unique<Network>();
+    try {
+        if (networkType == DetectorType::YuNet) {
+#ifdef FACESECURE_HAVE_YUNET
+            network->yunet = cv::FaceDetectorYN::create(modelFile, "", cv::Size(320, 320), scoreThreshold, 0.3f, 5000,
+                cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_CPU);
+            if (!network->yunet) {
+                return nullptr;
+            }
+#else
+            return nullptr;
+#endif
+        } else {
+            network->net = cv::dnn::readNetFromCaffe(configFile, modelFile);
+            if (network->net.empty()) {
+                return nullptr;
+            }
+            network->net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            network->net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        }
+    } catch (const cv::Exception&) {
+        return nullptr;
+    }
+    return network;
+}
+
+void DnnDetector::detectYuNet(Network& network, const cv::Mat& frame, int minFace, bool coarseToFine,
+                              std::vector<cv::Rect>& faces) const {
+#ifdef FACESECURE_HAVE_YUNET
+    cv::Mat input = frame;
+    double scale = coarseToFine ? std::min(1.0, kYuNetMinFace / std::max(1, minFace)) : 1.0;
+    cv::Mat small;
+    if (scale < 0.9) {
+        MatPool::usePool(small);
+        cv::resize(frame, small, cv::Size(), scale, scale, cv::INTER_AREA);
+        input = small;
+    } else {
+        scale = 1.0;
+    }
+
+    // Rows of x, y, w, h, five landmarks and the score
+    cv::Mat detections;
+    network.yunet->setInputSize(input.size());
+    network.yunet->detect(input, detections);
+
+    cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    for (int i = 0; i < detections.rows; ++i) {
+        cv::Rect box(cvRound(detections.at<float>(i, 0) / scale), cvRound(detections.at<float>(i, 1) / scale),
+            cvRound(detections.at<float>(i, 2) / scale), cvRound(detections.at<float>(i, 3) / scale));
+        box &= bounds;
+        if (box.width >= minFace && box.height > 0) {
+            faces.push_back(box);
+        }
+    }
+#else
+    (void)network;
+    (void)frame;
+    (void)minFace;
+    (void)coarseToFine;
+    (void)faces;
+#endif
+}
+
+void DnnDetector::detectSsd(Network& network, const cv::Mat& frame, int minFace, std::vector<cv::Rect>& faces) const {
+    cv::Mat blob = cv::dnn::blobFromImage(frame, 1.0, kSsdInput, kSsdMean, false, false);
+    network.net.setInput(blob);
+    cv::Mat output = network.net.forward();
+
+    // 1 x 1 x N x 7: image, class, score, then the box in [0, 1] coordinates
+    cv::Mat detections(output.size[2], output.size[3], CV_32F, output.ptr<float>());
+    cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    for (int i = 0; i < detections.rows; ++i) {
+        float score = detections.at<float>(i, 2);
+        if (score < scoreThreshold) continue;
+
+        cv::Point topLeft(cvRound(detections.at<float>(i, 3) * frame.cols),
+            cvRound(detections.at<float>(i, 4) * frame.rows));
+        cv::Point bottomRight(cvRound(detections.at<float>(i, 5) * frame.cols),
+            cvRound(detections.at<float>(i, 6) * frame.rows));
+        cv::Rect box = cv::Rect(topLeft, bottomRight) & bounds;
+        if (box.width >= minFace && box.height > 0) {
+            faces.push_back(box);
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#include "../../include/core/EnrollmentSession.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+// Crops are scored at a fixed size so sharpness does not depend on distance
+const cv::Size kScoreSize(100, 100);
+// Laplacian variance of a crisp face at kScoreSize
+const double kSharpVariance = 300.0;
+// Face width the recognizers get full detail from
+const double kFullDetailWidth = 150.0;
+// Thumbnail side used to compare candidates with each other
+const int kThumbnailSide = 24;
+// Thumbnail distance at which two candidates count as fully distinct
+const double kDistinctDistance = 0.6;
+// Consecutive failed reads before a camera counts as gone
+const int kMaxFailedReads = 30;
+
+} // namespace
+
+EnrollmentSession::EnrollmentSession(FaceDetector& detector)
+    : detector(detector), running(false), cancelled(false) {}
+
+EnrollmentSession::~EnrollmentSession() {
+    cancel();
+}
+
+bool EnrollmentSession::start(const EnrollmentConfig& config, ProgressCallback onProgress, FinishedCallback onFinished) {
+    if (running) {
+        return false;
+    }
+
+    // Reap a session that finished on its own
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    this->config = config;
+    progressCallback = std::move(onProgress);
+    finishedCallback = std::move(onFinished);
+
+    if (!openSource(config.source)) {
+        return false;
+    }
+
+    cancelled = false;
+    running = true;
+    worker = std::thread(&EnrollmentSession::captureLoop, this);
+    return true;
+}
+
+void EnrollmentSession::cancel() {
+    cancelled = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    running = false;
+    capture.release();
+}
+
+bool EnrollmentSession::isRunning() const {
+    return running;
+}
+
+EnrollmentCandidate EnrollmentSession::score(const cv::Mat& face) {
+    EnrollmentCandidate candidate;
+    candidate.face = face;
+    if (face.empty()) {
+        return candidate;
+    }
+
+    cv::Mat gray;
+    if (face.channels() == 3) {
+        cv::cvtColor(face, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = face;
+    }
+    cv::Mat scaled;
+    cv::resize(gray, scaled, kScoreSize, 0, 0, cv::INTER_AREA);
+
+    // Blur and motion smear flatten the second derivative
+    cv::Mat laplacian;
+    cv::Laplacian(scaled, laplacian, CV_64F);
+    cv::Scalar mean;
+    cv::Scalar deviation;
+    cv::meanStdDev(laplacian, mean, deviation);
+    candidate.sharpness = std::min(1.0, deviation[0] * deviation[0] / kSharpVariance);
+
+    candidate.size = std::min(1.0, face.cols / kFullDetailWidth);
+
+    // Best at mid-gray, falling to zero at black or white
+    double level = cv::mean(scaled)[0];
+    candidate.brightness = std::max(0.0, 1.0 - std::abs(level - 128.0) / 128.0);
+
+    // Sharpness matters most; a small or badly lit face still carries some detail
+    candidate.quality = std::sqrt(candidate.sharpness) * std::pow(candidate.size, 0.25) *
+        std::pow(candidate.brightness, 0.25);
+
+    // Zero mean and unit norm, so lighting changes alone do not look like pose changes
+    cv::Mat thumbnail;
+    cv::resize(scaled, thumbnail, cv::Size(kThumbnailSide, kThumbnailSide), 0, 0, cv::INTER_AREA);
+    thumbnail.convertTo(candidate.thumbnail, CV_32F);
+    candidate.thumbnail -= cv::mean(candidate.thumbnail);
+    double norm = cv::norm(candidate.thumbnail);
+    if (norm > 0.0) {
+        candidate.thumbnail /= norm;
+    }
+    return candidate;
+}
+
+std::vector<size_t> EnrollmentSession::select(const std::vector<EnrollmentCandidate>& candidates, int count) {
+    std::vector<size_t> selected;
+    std::vector<bool> taken(candidates.size(), false);
+
+    while (static_cast<int>(selected.size()) < count) {
+        size_t best = candidates.size();
+        double bestScore = -1.0;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (taken[i]) continue;
+
+            // The first pick is purely on quality
+            double diversity = 1.0;
+            if (!selected.empty()) {
+                double nearest = kDistinctDistance;
+                for (size_t j : selected) {
+                    nearest = std::min(nearest, cv::norm(candidates[i].thumbnail, candidates[j].thumbnail));
+                }
+                diversity = 0.5 + 0.5 * nearest / kDistinctDistance;
+            }
+
+            double weighted = candidates[i].quality * diversity;
+            if (weighted > bestScore) {
+                bestScore = weighted;
+                best = i;
+            }
+        }
+
+        if (best == candidates.size()) {
+            break;
+        }
+        taken[best] = true;
+        selected.push_back(best);
+    }
+    return selected;
+}
+
+bool EnrollmentSession::openSource(const std::string& source) {
+    bool isDevice = !source.empty() &&
+        std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c); });
+
+    try {
+        if (isDevice) {
+            return capture.open(std::stoi(source));
+        }
+        return capture.open(source);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+void EnrollmentSession::captureLoop() {
+    std::vector<EnrollmentCandidate> candidates;
+    auto started = std::chrono::steady_clock::now();
+    int failedReads = 0;
+    double bestQuality = 0.0;
+
+    while (!cancelled) {
+        cv::Mat frame;
+        if (!capture.read(frame) || frame.empty()) {
+            // Cameras often deliver a few empty frames while starting up
+            if (++failedReads >= kMaxFailedReads) break;
+            continue;
+        }
+        failedReads = 0;
+
+        Detection detection = detector.detect(frame, true);
+
+        // Only frames with exactly one face are unambiguous about who enrolls
+        if (detection.faces.size() == 1) {
+            EnrollmentCandidate candidate = score(frame(detection.faces[0]).clone());
+            if (candidate.quality >= config.minQuality) {
+                bestQuality = std::max(bestQuality, candidate.quality);
+                candidates.push_back(std::move(candidate));
+
+                if (candidates.size() > config.maxCandidates) {
+                    auto weakest = std::min_element(candidates.begin(), candidates.end(),
+                        [](const EnrollmentCandidate& a, const EnrollmentCandidate& b) { return a.quality < b.quality; });
+                    candidates.erase(weakest);
+                }
+            }
+        }
+
+        if (progressCallback) {
+            EnrollmentProgress progress;
+            progress.candidates = static_cast<int>(candidates.size());
+            progress.needed = config.samples;
+            progress.bestQuality = bestQuality;
+            progress.preview = detection.annotated;
+            progressCallback(std::move(progress));
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        bool enough = static_cast<int>(candidates.size()) >= config.samples;
+        if ((enough && elapsed >= config.burst) || elapsed >= config.timeout) {
+            break;
+        }
+    }
+
+    // Free the camera before the owner hears about the result
+    capture.release();
+    if (cancelled) {
+        running = false;
+        return;
+    }
+
+    EnrollmentResult result;
+    if (static_cast<int>(candidates.size()) < config.samples) {
+        result.error = "Only " + std::to_string(candidates.size()) + " of " + std::to_string(config.samples) +
+            " usable face images were captured";
+    } else {
+        for (size_t index : select(candidates, config.samples)) {
+            result.faces.push_back(candidates[index].face);
+            result.qualities.push_back(candidates[index].quality);
+        }
+        result.success = true;
+    }
+
+    running = false;
+    if (finishedCallback) {
+        finishedCallback(std::move(result));
+    }
+}
@@ -1,31 +1,100 @@
 #include "../../include/core/FaceDetector.hpp"
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
 
-FaceDetector::FaceDetector() {}
+FaceDetector::FaceDetector()
+    : minFaceSize(30), coarseToFine(false), frames(0), totalMicros(0), lastMicros(0), maxMicros(0) {}
 
 bool FaceDetector::initialize(const std::string& cascadeFile) {
-    return faceClassifier.load(cascadeFile);
+    return initialize(DetectorType::HaarCascade, cascadeFile);
 }
 
-std::vector<cv::Rect> FaceDetector::detectFaces(const cv::Mat& frame) {
-    cv::Mat grayFrame;
-    cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(grayFrame, grayFrame);
+bool FaceDetector::initialize(DetectorType type, const std::string& modelFile, const std::string& configFile) {
+    return initialize(DetectorBackend::create(type, modelFile, configFile));
+}
+
+bool FaceDetector::initialize(std::shared_ptr<DetectorBackend> shared) {
+    if (!shared) {
+        return false;
+    }
+    backend = std::move(shared);
+    resetStats();
+    return true;
+}
+
+std::shared_ptr<DetectorBackend> FaceDetector::getBackend() const {
+    return backend;
+}
+
+Detection FaceDetector::detect(const cv::Mat& frame, bool annotate) const {
+    Detection result;
+    if (!backend || frame.empty()) {
+        return result;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    result.faces = backend->detect(frame, minFaceSize, coarseToFine);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    result.milliseconds = elapsed.count() / 1000.0;
     
-    frame.copyTo(currentFrame);
-    faceClassifier.detectMultiScale(grayFrame, currentFaces, 
-        1.1, 3, 0, cv::Size(30, 30));
+    uint64_t micros = static_cast<uint64_t>(elapsed.count());
+    frames++;
+    totalMicros += micros;
+    lastMicros = micros;
+    uint64_t previousMax = maxMicros;
+    while (micros > previousMax && !maxMicros.compare_exchange_weak(previousMax, micros)) {
+        // Another thread raised the maximum meanwhile; compare again
+    }
     
-    drawFaceRectangles();
-    return currentFaces;
+    if (annotate) {
+        result.annotated = frame.clone();
+        drawFaceRectangles(result.annotated, result.faces);
+    }
+    return result;
 }
 
-cv::Mat FaceDetector::getAnnotatedFrame() const {
-    return currentFrame;
+std::vector<cv::Rect> FaceDetector::detectFaces(const cv::Mat& frame) const {
+    return detect(frame).faces;
 }
 
-void FaceDetector::drawFaceRectangles() {
-    for (const auto& face : currentFaces) {
-        cv::rectangle(currentFrame, face, cv::Scalar(0, 255, 0), 2);
+DetectorStats FaceDetector::getStats() const {
+    DetectorStats stats;
+    if (backend) {
+        stats.type = backend->type();
     }
-} 
\ No newline at end of file
+    stats.frames = frames;
+    stats.meanMs = stats.frames > 0 ? totalMicros / 1000.0 / stats.frames : 0.0;
+    stats.lastMs = lastMicros / 1000.0;
+    stats.maxMs = maxMicros / 1000.0;
+    return stats;
+}
+
+void FaceDetector::resetStats() {
+    frames = 0;
+    totalMicros = 0;
+    lastMicros = 0;
+    maxMicros = 0;
+}
+
+void FaceDetector::setMinFaceSize(int pixels) {
+    minFaceSize = std::max(1, pixels);
+}
+
+int FaceDetector::getMinFaceSize() const {
+    return minFaceSize;
+}
+
+void FaceDetector::setCoarseToFine(bool enabled) {
+    coarseToFine = enabled;
+}
+
+bool FaceDetector::isCoarseToFine() const {
+    return coarseToFine;
+}
+
+void FaceDetector::drawFaceRectangles(cv::Mat& frame, const std::vector<cv::Rect>& faces) {
+    for (const auto& face : faces) {
+        cv::rectangle(frame, face, cv::Scalar(0, 255, 0), 2);
+    }
+}
@@ -0,0 +1,92 @@
+#include "../../include/core/FaceQualityGate.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+namespace {
+
+// Blur is measured at a fixed size so it does not depend on face distance
+const cv::Size kAnalysisSize(64, 64);
+
+} // namespace
+
+FaceQualityGate::FaceQualityGate(const FaceQualityConfig& config)
+    : config(config), passed(0), tooSmall(0), blurred(0), exposure(0), aspect(0) {}
+
+FaceRejection FaceQualityGate::check(const cv::Mat& frame, const cv::Rect& box) {
+    FaceRejection reason = config.enabled ? evaluate(frame, box) : FaceRejection::None;
+    switch (reason) {
+    case FaceRejection::None: passed++; break;
+    case FaceRejection::TooSmall: tooSmall++; break;
+    case FaceRejection::Blurred: blurred++; break;
+    case FaceRejection::Exposure: exposure++; break;
+    case FaceRejection::Aspect: aspect++; break;
+    }
+    return reason;
+}
+
+FaceRejection FaceQualityGate::evaluate(const cv::Mat& frame, const cv::Rect& box) {
+    cv::Rect visible = box & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (std::min(visible.width, visible.height) < config.minSize) {
+        return FaceRejection::TooSmall;
+    }
+
+    double ratio = static_cast<double>(visible.width) / visible.height;
+    if (ratio < config.minAspect || ratio > config.maxAspect) {
+        return FaceRejection::Aspect;
+    }
+
+    // Shrink before converting, so only the small crop is converted
+    cv::resize(frame(visible), small, kAnalysisSize, 0, 0, cv::INTER_AREA);
+    if (small.channels() == 3) {
+        cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        small.copyTo(gray);
+    }
+
+    cv::Scalar mean;
+    cv::Scalar deviation;
+    cv::meanStdDev(gray, mean, deviation);
+    if (mean[0] < config.minBrightness || mean[0] > config.maxBrightness || deviation[0] < config.minContrast) {
+        return FaceRejection::Exposure;
+    }
+
+    cv::Laplacian(gray, laplacian, CV_16S);
+    cv::meanStdDev(laplacian, mean, deviation);
+    if (deviation[0] * deviation[0] < config.minSharpness) {
+        return FaceRejection::Blurred;
+    }
+    return FaceRejection::None;
+}
+
+FaceQualityStats FaceQualityGate::stats() const {
+    FaceQualityStats result;
+    result.passed = passed;
+    result.tooSmall = tooSmall;
+    result.blurred = blurred;
+    result.exposure = exposure;
+    result.aspect = aspect;
+    return result;
+}
+
+void FaceQualityGate::reset() {
+    passed = 0;
+    tooSmall = 0;
+    blurred = 0;
+    exposure = 0;
+    aspect = 0;
+}
+
+void FaceQualityGate::setConfig(const FaceQualityConfig& config) {
+    this->config = config;
+}
+
+const char* FaceQualityGate::reasonName(FaceRejection reason) {
+    switch (reason) {
+    case FaceRejection::None: return "passed";
+    case FaceRejection::TooSmall: return "too small";
+    case FaceRejection::Blurred: return "blurred";
+    case FaceRejection::Exposure: return "badly exposed";
+    case FaceRejection::Aspect: return "cut off";
+    }
+    return "";
+}
@@ -1,69 +1,644 @@
 #include "../../include/core/FaceRecognizer.hpp"
+#include "../../include/core/FileSync.hpp"
+#include "../../include/core/GalleryFile.hpp"
+#include "../../include/core/MatPool.hpp"
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 
-FaceRecognizer::FaceRecognizer() : nextLabel(0) {}
+namespace {
 
-bool FaceRecognizer::initialize() {
-    model = cv::face::LBPHFaceRecognizer::create();
+// Top-level node of YAML snapshots written by backends other than LBPH
+const char* const kYamlNode = "facesecure_gallery";
+
+} // namespace
+
+FaceRecognizer::FaceRecognizer()
+    : backend(RecognizerBackend::create(RecognizerType::Lbph)), index(matcher), approximate(false), nextLabel(0),
+      trainingDeferred(false) {}
+
+bool FaceRecognizer::initialize(RecognizerType type, const std::string& modelFile) {
+    std::shared_ptr<RecognizerBackend> created = RecognizerBackend::create(type, modelFile);
+    if (!created) {
+        return false;
+    }
+    backend = created;
+    
+    // Descriptors of one backend mean nothing to another
+    matcher.clear();
+    matcher.setMetric(backend->metric());
+    index.clear();
+    labelNames.clear();
+    nextLabel = 0;
+    samples.clear();
+    sampleLabels.clear();
+    journal.setPath(RecognizerBackend::defaultJournalFile(type));
     return true;
 }
 
-bool FaceRecognizer::train(const std::string& name, const std::vector<cv::Mat>& faceImages) {
+RecognizerType FaceRecognizer::getType() const {
+    return backend->type();
+}
+
+size_t FaceRecognizer::identityCount() const {
+    return labelNames.size();
+}
+
+std::vector<std::string> FaceRecognizer::identityNames() const {
+    std::vector<std::string> names;
+    for (const auto& entry : labelNames) {
+        names.push_back(entry.second);
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+bool FaceRecognizer::enroll(const std::string& name, const std::vector<cv::Mat>& faceImages) {
+    if (faceImages.empty()) {
+        return false;
+    }
+    
     std::vector<cv::Mat> processedImages;
+    for (const auto& image : faceImages) {
+        processedImages.push_back(preprocess(image));
+    }
+    
+    // Describe before journaling, so a face the backend cannot handle never
+    // reaches the journal
+    std::vector<cv::Mat> descriptors;
+    if (!backend->isTrainable() && !describeAll(processedImages, descriptors)) {
+        return false;
+    }
+    
+    // Journal first: a person must not be recognized until the enrollment
+    // would survive a restart
+    GalleryEntry entry;
+    entry.label = nextLabel;
+    entry.name = name;
+    entry.faces = std::move(processedImages);
+    if (!journal.append(entry)) {
+        return false;
+    }
+    applySamples(entry.label, name, entry.faces, descriptors);
+    return true;
+}
+
+bool FaceRecognizer::remove(const std::string& name) {
     std::vector<int> labels;
+    for (const auto& entry : labelNames) {
+        if (entry.second == name) {
+            labels.push_back(entry.first);
+        }
+    }
+    if (labels.empty()) {
+        return false;
+    }
+    
+    // Journal every removal before touching the gallery, like enroll(); a
+    // record without faces tells replay to drop the label
+    for (int label : labels) {
+        GalleryEntry entry;
+        entry.label = label;
+        entry.name = name;
+        if (!journal.append(entry)) {
+            return false;
+        }
+    }
+    for (int label : labels) {
+        removeLabel(label);
+    }
+    return true;
+}
+
+bool FaceRecognizer::train(const std::string& name, const std::vector<cv::Mat>& faceImages) {
+    return enroll(name, faceImages);
+}
+
+std::string FaceRecognizer::recognize(const cv::Mat& faceImage, double& confidence) {
+    Recognition result = match(preprocess(faceImage));
+    confidence = result.confidence;
+    return result.name;
+}
+
+std::vector<Recognition> FaceRecognizer::recognizeBatch(const std::vector<cv::Mat>& faceImages) {
+    std::vector<Recognition> results(faceImages.size());
+    
+    // Each face is independent: preprocessing and the gallery scan only
+    // read shared state, so faces are spread across cores
+    cv::parallel_for_(cv::Range(0, static_cast<int>(faceImages.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            try {
+                results[i] = match(preprocess(faceImages[i]));
+            } catch (const cv::Exception& e) {}
+        }
+    });
+    
+    return results;
+}
+
+bool FaceRecognizer::saveModel(const std::string& requested) {
+    std::string filename = requested.empty() ? RecognizerBackend::defaultGalleryFile(backend->type()) : requested;
+    
+    // Snapshots hold only live samples; compacting renumbers the rows, so
+    // the index has to be rebuilt over the new order
+    if (matcher.removedCount() > 0) {
+        matcher.compact();
+        index.clear();
+        if (approximate) {
+            index.build();
+        }
+    }
+    
+    bool saved = false;
+    if (hasExtension(filename, GalleryFile::extension())) {
+        // The binary layout has no room for training faces
+        if (backend->isTrainable()) {
+            return false;
+        }
+#ifdef _WIN32
+        // Windows cannot replace a file that is still mapped
+        matcher.detach();
+#endif
+        saved = GalleryFile::write(filename, backend->galleryParams(), matcher, labelNames);
+    } else {
+        saved = saveYaml(filename);
+    }
+    if (!saved) {
+        return false;
+    }
+    
+    // A stale index is worse than none: it would be rejected on load anyway
+    std::string indexFile = filename + ".hnsw";
+    if (index.size() > 0 && index.size() == matcher.size()) {
+        index.save(indexFile, GalleryFile::rowsChecksum(matcher));
+    } else {
+        std::remove(indexFile.c_str());
+    }
+    
+    // Everything journaled is now part of the snapshot
+    return journal.truncate();
+}
+
+bool FaceRecognizer::loadModel(const std::string& requested) {
+    std::string filename = requested.empty() ? RecognizerBackend::defaultGalleryFile(backend->type()) : requested;
+    bool loaded = false;
+    uint64_t rowsChecksum = 0;
+    
+    // Loading replaces the gallery
+    matcher.clear();
+    index.clear();
+    labelNames.clear();
+    samples.clear();
+    sampleLabels.clear();
+    nextLabel = 0;
+    
+    if (GalleryFile::isGalleryFile(filename)) {
+        // Descriptors stay in the mapped file; only labels and names are copied
+        GalleryParams params;
+        std::map<int, std::string> names;
+        if (GalleryFile::readParams(filename, params) && params.recognizer == static_cast<int>(backend->type()) &&
+            !backend->isTrainable() && GalleryFile::open(filename, params, matcher, names)) {
+            backend->setGalleryParams(params);
+            labelNames = std::move(names);
+            rowsChecksum = params.rowsChecksum;
+            loaded = true;
+        }
+    } else if (std::ifstream(filename).good()) {
+        // YAML parsing reads every row anyway
+        loaded = loadYaml(filename);
+        rowsChecksum = loaded ? GalleryFile::rowsChecksum(matcher) : 0;
+    }
+    if (loaded) {
+        for (size_t i = 0; i < matcher.size(); ++i) {
+            nextLabel = std::max(nextLabel, matcher.labelAt(i) + 1);
+        }
+        for (const auto& entry : labelNames) {
+            nextLabel = std::max(nextLabel, entry.first + 1);
+        }
+    } else {
+        // Drop whatever a snapshot that failed half way through left behind
+        matcher.clear();
+        labelNames.clear();
+        samples.clear();
+        sampleLabels.clear();
+    }
+    
+    // The index is only accepted if it was built over exactly these rows.
+    // Without approximate search it is never read.
+    index.clear();
+    if (loaded && approximate) {
+        index.load(filename + ".hnsw", rowsChecksum);
+    }
+    
+    // Replay enrollments made after the snapshot. A record whose label is
+    // already known was snapshotted before the journal could be cleared.
+    // A record without faces is a removal.
+    trainingDeferred = true;
+    journal.replay([this, &loaded](GalleryEntry&& entry) {
+        if (entry.faces.empty()) {
+            removeLabel(entry.label);
+        } else if (labelNames.count(entry.label) == 0 && addSamples(entry.label, entry.name, entry.faces)) {
+            loaded = true;
+        }
+    });
+    trainingDeferred = false;
+    if (backend->isTrainable() && journal.recordCount() > 0) {
+        retrain();
+    }
+    
+    if (approximate) {
+        index.build();
+    }
+    
+    return loaded;
+}
+
+bool FaceRecognizer::convertModel(const std::string& source, const std::string& destination) {
+    RecognizerType type = RecognizerType::Lbph;
+    FaceRecognizer converter;
+    if (!snapshotType(source, type) || !converter.initialize(type)) {
+        return false;
+    }
+    // Converting must not consume or clear the live journal
+    converter.setJournalFile("");
+    if (!converter.loadModel(source) || !converter.saveModel(destination)) {
+        return false;
+    }
+    
+    // Read the result back, checksums included
+    if (GalleryFile::isGalleryFile(destination)) {
+        GalleryParams params;
+        HistogramMatcher check;
+        std::map<int, std::string> names;
+        return GalleryFile::open(destination, params, check, names, true) &&
+            check.size() == converter.matcher.size();
+    }
+    return true;
+}
+
+void FaceRecognizer::setJournalFile(const std::string& filename) {
+    journal.setPath(filename);
+}
+
+size_t FaceRecognizer::pendingJournalRecords() const {
+    return journal.recordCount();
+}
+
+void FaceRecognizer::setApproximateSearch(bool enabled, int efSearch) {
+    approximate = enabled;
+    index.setEfSearch(efSearch);
+    if (approximate) {
+        index.build();
+    }
+}
+
+bool FaceRecognizer::isApproximateSearch() const {
+    return approximate;
+}
+
+double FaceRecognizer::measureRecall(const std::vector<cv::Mat>& faceImages) {
+    if (faceImages.empty() || matcher.size() == 0) {
+        return 1.0;
+    }
+    index.build();
     
+    int hits = 0;
+    HistogramMatcher::Buffer query;
     for (const auto& image : faceImages) {
-        processedImages.push_back(preprocessFace(image));
-        labels.push_back(nextLabel);
+        cv::Mat histogram = describe(preprocess(image));
+        if (histogram.empty()) continue;
+        HistogramMatcher::Match exact = matcher.nearest(histogram);
+        matcher.prepareQuery(histogram, query);
+        HistogramMatcher::Match approximated = index.nearest(query.data());
+        
+        // Equal distances count: either row is an exact nearest neighbour
+        if (approximated.index == exact.index || approximated.distance == exact.distance) {
+            hits++;
+        }
     }
+    return static_cast<double>(hits) / faceImages.size();
+}
+
+cv::Mat FaceRecognizer::preprocessFace(const cv::Mat& faceImage) {
+    // Per-thread scratch for the gray crop; the 100x100 result comes from
+    // the shared pool and goes back to it once the caller drops it
+    thread_local cv::Mat gray;
+    cv::cvtColor(faceImage, gray, cv::COLOR_BGR2GRAY);
     
-    labelNames[nextLabel] = name;
-    nextLabel++;
+    cv::Mat processed;
+    MatPool::usePool(processed);
+    cv::resize(gray, processed, cv::Size(100, 100));
+    cv::equalizeHist(processed, processed);
+    return processed;
+}
+
+cv::Mat FaceRecognizer::preprocess(const cv::Mat& faceImage) const {
+    return backend->preprocess(faceImage);
+}
+
+cv::Mat FaceRecognizer::describe(const cv::Mat& processed) const {
+    return backend->describe(processed);
+}
+
+Recognition FaceRecognizer::match(const cv::Mat& processed) const {
+    Recognition result;
     
     try {
-        model->train(processedImages, labels);
-        return true;
+        cv::Mat histogram = describe(processed);
+        if (histogram.empty()) {
+            return result;
+        }
+        HistogramMatcher::Match best;
+        if (approximate && matcher.size() > 0 && index.size() == matcher.size()) {
+            thread_local HistogramMatcher::Buffer query;
+            matcher.prepareQuery(histogram, query);
+            best = index.nearest(query.data());
+        }
+        if (best.index < 0) {
+            best = matcher.nearest(histogram);
+        }
+        if (best.index < 0) {
+            return result;
+        }
+        
+        // LBPH distances are used as they are; other backends are scaled
+        // onto the same range
+        result.label = best.label;
+        result.confidence = best.distance * (100.0 / backend->acceptDistance());
+        auto it = labelNames.find(result.label);
+        if (it != labelNames.end() && result.confidence < 100.0) {
+            result.name = it->second;
+        }
+    } catch (const cv::Exception& e) {}
+    
+    return result;
+}
+
+bool FaceRecognizer::addSamples(int label, const std::string& name, const std::vector<cv::Mat>& processedImages) {
+    std::vector<cv::Mat> descriptors;
+    if (!backend->isTrainable() && !describeAll(processedImages, descriptors)) {
+        return false;
+    }
+    applySamples(label, name, processedImages, descriptors);
+    return true;
+}
+
+bool FaceRecognizer::describeAll(const std::vector<cv::Mat>& processedImages, std::vector<cv::Mat>& descriptors) const {
+    try {
+        // Only the new samples are described; the gallery is not retrained
+        for (const auto& image : processedImages) {
+            descriptors.push_back(describe(image));
+            if (descriptors.back().empty()) {
+                return false;
+            }
+        }
     } catch (const cv::Exception& e) {
         return false;
     }
+    return true;
 }
 
-std::string FaceRecognizer::recognize(const cv::Mat& faceImage, double& confidence) {
-    cv::Mat processed = preprocessFace(faceImage);
-    int label = -1;
+void FaceRecognizer::applySamples(int label, const std::string& name, const std::vector<cv::Mat>& processedImages,
+                                  const std::vector<cv::Mat>& descriptors) {
+    labelNames[label] = name;
+    nextLabel = std::max(nextLabel, label + 1);
     
-    try {
-        model->predict(processed, label, confidence);
-        if (label != -1 && confidence < 100.0) {
-            return labelNames[label];
+    if (backend->isTrainable()) {
+        // The projection depends on every sample, so all of them are kept
+        // and described again once the model is retrained
+        samples.insert(samples.end(), processedImages.begin(), processedImages.end());
+        sampleLabels.insert(sampleLabels.end(), processedImages.size(), label);
+        if (!trainingDeferred) {
+            retrain();
         }
-    } catch (const cv::Exception& e) {}
+        return;
+    }
+    
+    for (const auto& descriptor : descriptors) {
+        matcher.add(descriptor, label);
+    }
+    if (approximate) {
+        index.build();
+    }
+}
+
+void FaceRecognizer::removeLabel(int label) {
+    labelNames.erase(label);
+    if (backend->isTrainable()) {
+        size_t kept = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            if (sampleLabels[i] != label) {
+                samples[kept] = samples[i];
+                sampleLabels[kept] = sampleLabels[i];
+                kept++;
+            }
+        }
+        if (kept == samples.size()) {
+            return;
+        }
+        samples.resize(kept);
+        sampleLabels.resize(kept);
+        if (!trainingDeferred) {
+            retrain();
+        }
+        return;
+    }
     
-    return "Unknown";
+    for (size_t row : matcher.removeLabel(label)) {
+        index.markDeleted(row);
+    }
 }
 
-bool FaceRecognizer::saveModel(const std::string& filename) {
+bool FaceRecognizer::retrain() {
+    matcher.clear();
+    index.clear();
+    
+    bool trained = !samples.empty() && backend->train(samples, sampleLabels);
+    if (trained) {
+        try {
+            for (size_t i = 0; i < samples.size(); ++i) {
+                matcher.add(describe(samples[i]), sampleLabels[i]);
+            }
+        } catch (const cv::Exception& e) {
+            matcher.clear();
+            trained = false;
+        }
+    }
+    if (approximate) {
+        index.build();
+    }
+    return trained;
+}
+
+bool FaceRecognizer::hasExtension(const std::string& filename, const std::string& extension) {
+    return filename.size() >= extension.size() &&
+        filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+bool FaceRecognizer::saveYaml(const std::string& filename) const {
+    // Written beside the target and renamed over it, like binary galleries.
+    // The temporary's extension says nothing, so the format is passed on.
+    std::string temporary = filename + ".tmp";
+    int format = hasExtension(filename, ".xml") ? cv::FileStorage::FORMAT_XML :
+        hasExtension(filename, ".json") ? cv::FileStorage::FORMAT_JSON : cv::FileStorage::FORMAT_YAML;
     try {
-        model->save(filename);
-        return true;
+        cv::FileStorage fs(temporary, cv::FileStorage::WRITE | format);
+        if (!fs.isOpened()) {
+            return false;
+        }
+        
+        // Labels of the rows, or of the samples the rows are rebuilt from
+        const std::vector<int>* rowLabels = backend->isTrainable() ? &sampleLabels : nullptr;
+        int count = rowLabels ? static_cast<int>(rowLabels->size()) : static_cast<int>(matcher.size());
+        cv::Mat labels(count, 1, CV_32S);
+        for (int i = 0; i < count; ++i) {
+            labels.at<int>(i) = rowLabels ? (*rowLabels)[i] : matcher.labelAt(i);
+        }
+        
+        if (backend->type() == RecognizerType::Lbph) {
+            // Same layout LBPHFaceRecognizer::save() writes, so snapshots
+            // stay readable by stock OpenCV tools
+            GalleryParams params = backend->galleryParams();
+            fs << "opencv_lbphfaces" << "{";
+            fs << "threshold" << params.threshold;
+            fs << "radius" << params.radius;
+            fs << "neighbors" << params.neighbors;
+            fs << "grid_x" << params.gridX;
+            fs << "grid_y" << params.gridY;
+            fs << "histograms" << "[";
+        } else {
+            fs << kYamlNode << "{";
+            fs << "recognizer" << RecognizerBackend::typeName(backend->type());
+            fs << "model" << "{";
+            backend->write(fs);
+            fs << "}";
+            fs << (rowLabels ? "samples" : "descriptors") << "[";
+        }
+        for (int i = 0; i < count; ++i) {
+            fs << (rowLabels ? samples[i] : matcher.histogramAt(i));
+        }
+        fs << "]";
+        fs << "labels" << labels;
+        fs << "labelsInfo" << "[";
+        for (const auto& entry : labelNames) {
+            fs << "{" << "label" << entry.first << "value" << entry.second << "}";
+        }
+        fs << "]";
+        fs << "}";
+        fs.release();
     } catch (const cv::Exception& e) {
+        std::remove(temporary.c_str());
         return false;
     }
+    
+    // The journal is cleared once this returns, so the snapshot must be on disk
+    if (!syncFile(temporary)) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return replaceFile(temporary, filename);
 }
 
-bool FaceRecognizer::loadModel(const std::string& filename) {
+bool FaceRecognizer::loadYaml(const std::string& filename) {
     try {
-        model->read(filename);
-        return true;
+        cv::FileStorage fs(filename, cv::FileStorage::READ);
+        cv::FileNode root = fs[kYamlNode];
+        bool lbph = backend->type() == RecognizerType::Lbph;
+        if (lbph) {
+            root = fs.getFirstTopLevelNode();
+            if (root["histograms"].empty()) {
+                root = fs.root();
+            }
+        } else if (root.empty() ||
+                   static_cast<std::string>(root["recognizer"]) != RecognizerBackend::typeName(backend->type())) {
+            return false;
+        }
+        
+        if (lbph) {
+            GalleryParams params = backend->galleryParams();
+            cv::read(root["radius"], params.radius, params.radius);
+            cv::read(root["neighbors"], params.neighbors, params.neighbors);
+            cv::read(root["grid_x"], params.gridX, params.gridX);
+            cv::read(root["grid_y"], params.gridY, params.gridY);
+            cv::read(root["threshold"], params.threshold, params.threshold);
+            backend->setGalleryParams(params);
+        } else if (!backend->read(root["model"])) {
+            return false;
+        }
+        
+        cv::Mat labels;
+        cv::read(root["labels"], labels);
+        
+        matcher.clear();
+        samples.clear();
+        sampleLabels.clear();
+        const char* rowsKey = lbph ? "histograms" : (backend->isTrainable() ? "samples" : "descriptors");
+        int row = 0;
+        for (const auto& node : root[rowsKey]) {
+            if (row >= static_cast<int>(labels.total())) break;
+            
+            cv::Mat values;
+            cv::read(node, values);
+            int label = labels.at<int>(row++);
+            if (backend->isTrainable()) {
+                samples.push_back(values);
+                sampleLabels.push_back(label);
+                // Rows come from the stored model; untrained models have none
+                cv::Mat descriptor = describe(values);
+                if (!descriptor.empty()) {
+                    matcher.add(descriptor, label);
+                }
+            } else {
+                matcher.add(values, label);
+            }
+        }
+        
+        // Names are stored as label info inside the snapshot
+        for (const auto& node : root["labelsInfo"]) {
+            int label = -1;
+            std::string name;
+            cv::read(node["label"], label, -1);
+            cv::read(node["value"], name, std::string());
+            if (!name.empty()) {
+                labelNames[label] = name;
+            }
+        }
     } catch (const cv::Exception& e) {
         return false;
     }
+    return true;
 }
 
-cv::Mat FaceRecognizer::preprocessFace(const cv::Mat& faceImage) {
-    cv::Mat processed;
-    cv::cvtColor(faceImage, processed, cv::COLOR_BGR2GRAY);
-    cv::resize(processed, processed, cv::Size(100, 100));
-    cv::equalizeHist(processed, processed);
-    return processed;
-} 
\ No newline at end of file
+bool FaceRecognizer::snapshotType(const std::string& filename, RecognizerType& type) {
+    if (GalleryFile::isGalleryFile(filename)) {
+        GalleryParams params;
+        if (!GalleryFile::readParams(filename, params)) {
+            return false;
+        }
+        for (RecognizerType candidate : RecognizerBackend::allTypes()) {
+            if (static_cast<int>(candidate) == params.recognizer) {
+                type = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // YAML without our node is an LBPH model, ours or stock OpenCV's
+    try {
+        cv::FileStorage fs(filename, cv::FileStorage::READ);
+        if (!fs.isOpened()) {
+            return false;
+        }
+        cv::FileNode root = fs[kYamlNode];
+        if (root.empty()) {
+            type = RecognizerType::Lbph;
+            return true;
+        }
+        return RecognizerBackend::parseType(static_cast<std::string>(root["recognizer"]), type);
+    } catch (const cv::Exception& e) {
+        return false;
+    }
+}
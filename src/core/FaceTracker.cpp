@@ -0,0 +1,161 @@
+#include "../../include/core/FaceTracker.hpp"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video.hpp>
+#include "../../include/core/MatPool.hpp"
+#include <algorithm>
+#include <tuple>
+
+FaceTracker::FaceTracker(const TrackerConfig& config) : config(config), nextId(1) {}
+
+void FaceTracker::update(const cv::Mat& frame, const std::vector<cv::Rect>& detections) {
+    // Becomes previousGray; the pool hands the older buffer back next frame
+    cv::Mat gray;
+    MatPool::usePool(gray);
+    if (config.opticalFlow && !frame.empty()) {
+        if (frame.channels() == 3) {
+            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        } else {
+            gray = frame;
+        }
+    }
+
+    // Greedy association: best-overlapping pairs first
+    std::vector<std::tuple<double, size_t, size_t>> pairs;
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        for (size_t d = 0; d < detections.size(); ++d) {
+            double overlap = iou(tracks[t].box, detections[d]);
+            if (overlap >= config.iouThreshold) {
+                pairs.emplace_back(overlap, t, d);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(),
+        [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+
+    std::vector<bool> trackMatched(tracks.size(), false);
+    std::vector<bool> detectionMatched(detections.size(), false);
+    for (const auto& pair : pairs) {
+        size_t t = std::get<1>(pair);
+        size_t d = std::get<2>(pair);
+        if (trackMatched[t] || detectionMatched[d]) continue;
+
+        trackMatched[t] = true;
+        detectionMatched[d] = true;
+        tracks[t].box = detections[d];
+        tracks[t].missed = 0;
+        tracks[t].visible = true;
+    }
+
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        if (trackMatched[t]) continue;
+
+        Track& track = tracks[t];
+        track.missed++;
+        track.visible = !gray.empty() && !previousGray.empty() && propagate(gray, track.box);
+    }
+
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(),
+        [this](const Track& track) { return track.missed > config.maxMissedFrames; }), tracks.end());
+
+    for (auto& track : tracks) {
+        track.sinceRecognition++;
+    }
+
+    for (size_t d = 0; d < detections.size(); ++d) {
+        if (detectionMatched[d]) continue;
+
+        Track track;
+        track.id = nextId++;
+        track.box = detections[d];
+        track.visible = true;
+        tracks.push_back(std::move(track));
+    }
+
+    previousGray = gray;
+}
+
+bool FaceTracker::needsRecognition(const Track& track) const {
+    if (!track.visible) return false;
+    if (!track.recognized) return true;
+
+    if (track.name == "Unknown") {
+        return track.sinceRecognition >= config.unknownRetryInterval;
+    }
+    return config.reverifyInterval > 0 && track.sinceRecognition >= config.reverifyInterval;
+}
+
+void FaceTracker::setIdentity(int trackId, const std::string& name, double confidence) {
+    for (auto& track : tracks) {
+        if (track.id == trackId) {
+            track.name = name;
+            track.confidence = confidence;
+            track.recognized = true;
+            track.sinceRecognition = 0;
+            return;
+        }
+    }
+}
+
+const std::vector<Track>& FaceTracker::getTracks() const {
+    return tracks;
+}
+
+void FaceTracker::reset() {
+    tracks.clear();
+    previousGray.release();
+}
+
+void FaceTracker::setConfig(const TrackerConfig& config) {
+    this->config = config;
+    if (!config.opticalFlow) {
+        previousGray.release();
+    }
+}
+
+bool FaceTracker::propagate(const cv::Mat& gray, cv::Rect& box) const {
+    cv::Rect bounds(0, 0, gray.cols, gray.rows);
+    cv::Rect roi = box & bounds;
+    if (roi.area() == 0 || previousGray.size() != gray.size()) {
+        return false;
+    }
+
+    std::vector<cv::Point2f> before;
+    cv::goodFeaturesToTrack(previousGray(roi), before, 20, 0.01, 3);
+    if (before.size() < 4) {
+        return false;
+    }
+    for (auto& point : before) {
+        point += cv::Point2f(static_cast<float>(roi.x), static_cast<float>(roi.y));
+    }
+
+    std::vector<cv::Point2f> after;
+    std::vector<unsigned char> status;
+    std::vector<float> error;
+    cv::calcOpticalFlowPyrLK(previousGray, gray, before, after, status, error);
+
+    std::vector<float> dx;
+    std::vector<float> dy;
+    for (size_t i = 0; i < status.size(); ++i) {
+        if (status[i]) {
+            dx.push_back(after[i].x - before[i].x);
+            dy.push_back(after[i].y - before[i].y);
+        }
+    }
+    if (dx.size() < 4) {
+        return false;
+    }
+
+    // Median is robust to the background points a face box always contains
+    std::nth_element(dx.begin(), dx.begin() + dx.size() / 2, dx.end());
+    std::nth_element(dy.begin(), dy.begin() + dy.size() / 2, dy.end());
+    box.x += cvRound(dx[dx.size() / 2]);
+    box.y += cvRound(dy[dy.size() / 2]);
+
+    return (box & bounds).area() > 0;
+}
+
+double FaceTracker::iou(const cv::Rect& a, const cv::Rect& b) {
+    int intersection = (a & b).area();
+    if (intersection == 0) return 0.0;
+    return static_cast<double>(intersection) / (a.area() + b.area() - intersection);
+}
@@ -0,0 +1,58 @@
+#include "../../include/core/FileSync.hpp"
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool syncFile(const std::string& path) {
+    // Append mode, so opening never truncates what was written
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        return false;
+    }
+    bool ok = syncFile(file);
+    return std::fclose(file) == 0 && ok;
+}
+
+bool syncParentDirectory(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    fs::path parent = fs::path(path).parent_path();
+    if (parent.empty()) {
+        parent = ".";
+    }
+    int directory = open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory < 0) {
+        return false;
+    }
+    bool ok = fsync(directory) == 0;
+    return close(directory) == 0 && ok;
+#endif
+}
+
+bool replaceFile(const std::string& temporary, const std::string& path) {
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return syncParentDirectory(path);
+}
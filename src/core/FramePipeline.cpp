@@ -0,0 +1,254 @@
+#include "../../include/core/FramePipeline.hpp"
+#include "../../include/core/MatPool.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cctype>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+FramePipeline::FramePipeline(FaceDetector& detector, FaceRecognizer& recognizer)
+    : detector(detector), recognizer(recognizer), running(false), dropped(0), recognitions(0), skipped(0), processed(0) {}
+
+FramePipeline::~FramePipeline() {
+    stop();
+}
+
+bool FramePipeline::start(const PipelineConfig& config, ResultCallback onResult, FinishedCallback onFinished) {
+    if (running) {
+        return false;
+    }
+
+    // Reap stages left over from a stream that ended on its own
+    stop();
+
+    this->config = config;
+    this->onResult = std::move(onResult);
+    this->onFinished = std::move(onFinished);
+
+    if (!openSource(config.source)) {
+        return false;
+    }
+
+    detectQueue.reset(config.queueCapacity);
+    recognizeQueue.reset(config.queueCapacity);
+    presentQueue.reset(config.queueCapacity);
+    tracker.setConfig(config.tracker);
+    tracker.reset();
+    motionGate.setConfig(config.motionGate);
+    qualityGate.setConfig(config.faceQuality);
+    qualityGate.reset();
+    voter.setConfig(config.voting);
+    voter.reset();
+    dropped = 0;
+    recognitions = 0;
+    skipped = 0;
+    processed = 0;
+    running = true;
+
+    // OpenCV creates its worker pool on first use and the workers inherit
+    // the creator's affinity; create it here, before any stage is pinned
+    cv::parallel_for_(cv::Range(0, cv::getNumThreads()), [](const cv::Range&) {});
+
+    captureThread = std::thread(&FramePipeline::captureLoop, this);
+    detectThread = std::thread(&FramePipeline::detectLoop, this);
+    recognizeThread = std::thread(&FramePipeline::recognizeLoop, this);
+    presentThread = std::thread(&FramePipeline::presentLoop, this);
+    return true;
+}
+
+void FramePipeline::stop() {
+    running = false;
+    detectQueue.close();
+    recognizeQueue.close();
+    presentQueue.close();
+
+    for (std::thread* stage : {&captureThread, &detectThread, &recognizeThread, &presentThread}) {
+        if (stage->joinable()) {
+            stage->join();
+        }
+    }
+
+    capture.release();
+}
+
+bool FramePipeline::isRunning() const {
+    return running;
+}
+
+uint64_t FramePipeline::droppedFrames() const {
+    return dropped;
+}
+
+uint64_t FramePipeline::recognizerCalls() const {
+    return recognitions;
+}
+
+uint64_t FramePipeline::skippedDetections() const {
+    return skipped;
+}
+
+uint64_t FramePipeline::processedFrames() const {
+    return processed;
+}
+
+FaceQualityStats FramePipeline::faceQualityStats() const {
+    return qualityGate.stats();
+}
+
+uint64_t FramePipeline::identityCommits() const {
+    return voter.commits();
+}
+
+void FramePipeline::captureLoop() {
+    uint64_t index = 0;
+
+    while (running) {
+        // Frame buffers return to the pool when the last stage lets go
+        FramePacket packet;
+        MatPool::usePool(packet.frame);
+        if (!capture.read(packet.frame) || packet.frame.empty()) {
+            break;
+        }
+        packet.index = index++;
+
+        if (config.dropFrames) {
+            int result = detectQueue.pushLatest(std::move(packet));
+            if (result < 0) break;
+            dropped += result;
+        } else if (!detectQueue.push(std::move(packet))) {
+            break;
+        }
+    }
+
+    // End of stream: let downstream stages drain and exit
+    detectQueue.close();
+}
+
+void FramePipeline::detectLoop() {
+    if (config.pinThreads) {
+        pinToCore(config.firstCore);
+    }
+
+    FramePacket packet;
+    std::vector<cv::Rect> lastFaces;
+    while (detectQueue.pop(packet)) {
+        if (motionGate.shouldDetect(packet.frame)) {
+            lastFaces = detector.detectFaces(packet.frame);
+        } else {
+            skipped++;
+        }
+        packet.faces = lastFaces;
+        if (!recognizeQueue.push(std::move(packet))) {
+            break;
+        }
+    }
+    recognizeQueue.close();
+}
+
+void FramePipeline::recognizeLoop() {
+    if (config.pinThreads) {
+        pinToCore(config.firstCore + 1);
+    }
+
+    FramePacket packet;
+    while (recognizeQueue.pop(packet)) {
+        tracker.update(packet.frame, packet.faces);
+        voter.retain(tracker.getTracks());
+
+        // Recognize every track that is new, due for re-verification or still
+        // collecting votes in one batch. Faces failing the quality gate stay
+        // due and are tried on the next frame.
+        std::vector<int> pendingTracks;
+        std::vector<cv::Mat> crops;
+        cv::Rect bounds(0, 0, packet.frame.cols, packet.frame.rows);
+        for (const auto& track : tracker.getTracks()) {
+            bool due = tracker.needsRecognition(track) || (track.visible && voter.wantsEvidence(track.id));
+            if (due && qualityGate.check(packet.frame, track.box) == FaceRejection::None) {
+                pendingTracks.push_back(track.id);
+                crops.push_back(packet.frame(track.box & bounds));
+            }
+        }
+        
+        std::vector<int> committedTracks;
+        if (!crops.empty()) {
+            std::vector<Recognition> recognized = recognizer.recognizeBatch(crops);
+            for (size_t i = 0; i < recognized.size(); ++i) {
+                tracker.setIdentity(pendingTracks[i], recognized[i].name, recognized[i].confidence);
+                if (voter.observe(pendingTracks[i], recognized[i].name, recognized[i].confidence)) {
+                    committedTracks.push_back(pendingTracks[i]);
+                }
+            }
+            recognitions += crops.size();
+        }
+
+        packet.results.clear();
+        packet.results.reserve(tracker.getTracks().size());
+
+        for (const auto& track : tracker.getTracks()) {
+            if (!track.visible) continue;
+
+            // Once committed, a track keeps its name until votes settle on another
+            std::string committed = voter.committedName(track.id);
+            FaceResult result;
+            result.box = track.box;
+            result.name = committed.empty() ? track.name : committed;
+            result.confidence = track.confidence;
+            result.trackId = track.id;
+            result.committed = std::find(committedTracks.begin(), committedTracks.end(), track.id) != committedTracks.end();
+            packet.results.push_back(std::move(result));
+        }
+
+        if (!presentQueue.push(std::move(packet))) {
+            break;
+        }
+    }
+    presentQueue.close();
+}
+
+void FramePipeline::presentLoop() {
+    FramePacket packet;
+    while (presentQueue.pop(packet)) {
+        // Frames leave untouched; the display draws boxes and names itself
+        if (onResult) {
+            FrameResult result;
+            result.frameIndex = packet.index;
+            result.frame = std::move(packet.frame);
+            result.faces = std::move(packet.results);
+            onResult(std::move(result));
+        }
+        processed++;
+    }
+    running = false;
+    if (onFinished) {
+        onFinished();
+    }
+}
+
+bool FramePipeline::openSource(const std::string& source) {
+    bool isDevice = !source.empty() &&
+        std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c); });
+
+    if (isDevice) {
+        return capture.open(std::stoi(source));
+    }
+    return capture.open(source);
+}
+
+void FramePipeline::pinToCore(unsigned core) {
+#ifdef __linux__
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores < 3) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
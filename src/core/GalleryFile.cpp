@@ -0,0 +1,292 @@
+#include "../../include/core/GalleryFile.hpp"
+#include "../../include/core/FileSync.hpp"
+#include "../../include/core/MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'F', 'S', 'G', 'L'};
+const uint32_t kVersion = 1;
+// Histogram rows start on a cache line, as HistogramMatcher requires
+const uint64_t kRowAlignment = 64;
+
+const uint64_t kChecksumSeed = 14695981039346656037ull;
+const uint64_t kChecksumPrime = 1099511628211ull;
+
+// Fixed-size file header, written in host byte order. A big-endian reader
+// sees a different version and rejects the file.
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    int32_t radius;
+    int32_t neighbors;
+    int32_t gridX;
+    int32_t gridY;
+    uint32_t dims;
+    uint32_t stride;
+    // RecognizerType of the rows; 0 (LBPH) in files from before backends
+    uint32_t recognizer;
+    double threshold;
+    uint64_t count;
+    uint64_t labelsOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t rowsOffset;
+    uint64_t fileSize;
+    uint64_t rowsChecksum;
+    uint64_t metaChecksum;
+    // Covers every field above
+    uint64_t headerChecksum;
+};
+static_assert(sizeof(Header) == 120, "gallery header layout changed");
+
+// FNV-1a over 64-bit words, so a multi-GB matrix hashes at memory speed.
+// Chunks hashed one after another give the same result as one call as long
+// as every chunk but the last is a multiple of 8 bytes.
+uint64_t checksum(const char* bytes, size_t length, uint64_t hash = kChecksumSeed) {
+    size_t words = length / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+        hash = (hash ^ word) * kChecksumPrime;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < length; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * kChecksumPrime;
+    }
+    return hash;
+}
+
+uint64_t headerChecksum(const Header& header) {
+    return checksum(reinterpret_cast<const char*>(&header), offsetof(Header, headerChecksum));
+}
+
+template<typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool getValue(const char* in, size_t size, size_t& offset, T& value) {
+    if (offset + sizeof(value) > size) return false;
+    std::memcpy(&value, in + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+} // namespace
+
+const char* GalleryFile::extension() {
+    return ".gallery";
+}
+
+bool GalleryFile::isGalleryFile(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(kMagic)] = {};
+    bool matches = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+        std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    std::fclose(file);
+    return matches;
+}
+
+bool GalleryFile::readParams(const std::string& path, GalleryParams& params) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    Header header;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+        header.headerSize == sizeof(Header) && header.headerChecksum == headerChecksum(header);
+    std::fclose(file);
+    if (!valid) {
+        return false;
+    }
+
+    params.radius = header.radius;
+    params.neighbors = header.neighbors;
+    params.gridX = header.gridX;
+    params.gridY = header.gridY;
+    params.threshold = header.threshold;
+    params.recognizer = static_cast<int>(header.recognizer);
+    params.rowsChecksum = header.rowsChecksum;
+    return true;
+}
+
+bool GalleryFile::write(const std::string& path, const GalleryParams& params,
+                        const HistogramMatcher& matcher, const std::map<int, std::string>& names) {
+    int dims = matcher.dimensions();
+    size_t stride = dims > 0 ? HistogramMatcher::rowStride(dims) : 0;
+
+    // Labels and names are small; build them in memory
+    std::string meta;
+    uint64_t count = 0;
+    for (size_t i = 0; i < matcher.size(); ++i) {
+        if (matcher.isRemoved(i)) continue;
+        putValue<int32_t>(meta, matcher.labelAt(i));
+        count++;
+    }
+    size_t labelsSize = meta.size();
+    for (const auto& entry : names) {
+        putValue<int32_t>(meta, entry.first);
+        putValue<uint32_t>(meta, static_cast<uint32_t>(entry.second.size()));
+        meta.append(entry.second);
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(Header);
+    header.radius = params.radius;
+    header.neighbors = params.neighbors;
+    header.gridX = params.gridX;
+    header.gridY = params.gridY;
+    header.threshold = params.threshold;
+    header.recognizer = static_cast<uint32_t>(params.recognizer);
+    header.dims = static_cast<uint32_t>(dims);
+    header.stride = static_cast<uint32_t>(stride);
+    header.count = count;
+    header.labelsOffset = sizeof(Header);
+    header.namesOffset = header.labelsOffset + labelsSize;
+    header.namesSize = meta.size() - labelsSize;
+    header.rowsOffset = (header.labelsOffset + meta.size() + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+    header.fileSize = header.rowsOffset + count * stride * sizeof(float);
+    header.metaChecksum = checksum(meta.data(), meta.size());
+
+    // Write beside the target and rename, so readers only ever see a whole file
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(meta.data(), 1, meta.size(), file) == meta.size();
+    std::string padding(header.rowsOffset - header.labelsOffset - meta.size(), '\0');
+    ok = ok && std::fwrite(padding.data(), 1, padding.size(), file) == padding.size();
+
+    // Rows go out exactly as the matcher holds them, padding included
+    uint64_t rowsChecksum = kChecksumSeed;
+    size_t rowBytes = stride * sizeof(float);
+    for (size_t i = 0; ok && i < matcher.size(); ++i) {
+        if (matcher.isRemoved(i)) continue;
+        const char* row = reinterpret_cast<const char*>(matcher.rowData(i));
+        ok = std::fwrite(row, 1, rowBytes, file) == rowBytes;
+        rowsChecksum = checksum(row, rowBytes, rowsChecksum);
+    }
+
+    // The header goes last, once the checksums are known
+    header.rowsChecksum = rowsChecksum;
+    header.headerChecksum = headerChecksum(header);
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = syncFile(file) && ok;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok) {
+        std::error_code error;
+        fs::remove(temporary, error);
+        return false;
+    }
+    return replaceFile(temporary, path);
+}
+
+bool GalleryFile::open(const std::string& path, GalleryParams& params, HistogramMatcher& matcher,
+                       std::map<int, std::string>& names, bool verifyRows) {
+    auto mapped = std::make_shared<MappedFile>();
+    if (!mapped->open(path) || mapped->size() < sizeof(Header)) {
+        return false;
+    }
+    const char* base = mapped->data();
+    size_t size = mapped->size();
+
+    Header header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.headerSize != sizeof(Header) || header.headerChecksum != headerChecksum(header)) {
+        return false;
+    }
+
+    // Section bounds must agree with each other and with the file size, so
+    // nothing below can read past the mapping
+    size_t rowBytes = static_cast<size_t>(header.stride) * sizeof(float);
+    bool consistent = header.fileSize == size &&
+        (header.count == 0 || (header.dims > 0 && header.stride == HistogramMatcher::rowStride(header.dims))) &&
+        header.labelsOffset == sizeof(Header) &&
+        header.count <= (size - sizeof(Header)) / sizeof(int32_t) &&
+        header.namesOffset == header.labelsOffset + header.count * sizeof(int32_t) &&
+        header.namesSize <= size - header.namesOffset &&
+        header.rowsOffset % kRowAlignment == 0 &&
+        header.rowsOffset >= header.namesOffset + header.namesSize &&
+        header.rowsOffset <= size &&
+        (rowBytes == 0 || header.count <= (size - header.rowsOffset) / rowBytes) &&
+        header.rowsOffset + header.count * rowBytes == size;
+    if (!consistent) {
+        return false;
+    }
+
+    const char* meta = base + header.labelsOffset;
+    size_t metaSize = header.namesOffset + header.namesSize - header.labelsOffset;
+    if (checksum(meta, metaSize) != header.metaChecksum) {
+        return false;
+    }
+    const char* rows = base + header.rowsOffset;
+    if (verifyRows && checksum(rows, header.count * rowBytes) != header.rowsChecksum) {
+        return false;
+    }
+
+    std::vector<int> labels(header.count);
+    if (header.count > 0) {
+        std::memcpy(labels.data(), meta, header.count * sizeof(int32_t));
+    }
+
+    std::map<int, std::string> loadedNames;
+    const char* namesData = base + header.namesOffset;
+    size_t offset = 0;
+    while (offset < header.namesSize) {
+        int32_t label = 0;
+        uint32_t length = 0;
+        if (!getValue(namesData, header.namesSize, offset, label) ||
+            !getValue(namesData, header.namesSize, offset, length) ||
+            length > header.namesSize - offset) {
+            return false;
+        }
+        loadedNames[label] = std::string(namesData + offset, length);
+        offset += length;
+    }
+
+    params.radius = header.radius;
+    params.neighbors = header.neighbors;
+    params.gridX = header.gridX;
+    params.gridY = header.gridY;
+    params.threshold = header.threshold;
+    params.recognizer = static_cast<int>(header.recognizer);
+    params.rowsChecksum = header.rowsChecksum;
+    names = std::move(loadedNames);
+    if (header.count > 0) {
+        matcher.attach(mapped, reinterpret_cast<const float*>(rows), static_cast<int>(header.dims), std::move(labels));
+    } else {
+        matcher.clear();
+    }
+    return true;
+}
+
+uint64_t GalleryFile::rowsChecksum(const HistogramMatcher& matcher) {
+    size_t rowBytes = matcher.dimensions() > 0 ? HistogramMatcher::rowStride(matcher.dimensions()) * sizeof(float) : 0;
+    uint64_t hash = kChecksumSeed;
+    for (size_t i = 0; i < matcher.size(); ++i) {
+        if (matcher.isRemoved(i)) continue;
+        hash = checksum(reinterpret_cast<const char*>(matcher.rowData(i)), rowBytes, hash);
+    }
+    return hash;
+}
@@ -0,0 +1,245 @@
+#include "../../include/core/GalleryJournal.hpp"
+#include "../../include/core/FileSync.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+const char kFileMagic[4] = {'F', 'S', 'G', 'J'};
+// Version 1 files hold only REC1 records, the only kind older builds read.
+// A file is moved to version 2 when its first REC2 record is appended.
+const uint32_t kFileVersion = 1;
+const uint32_t kTypedFileVersion = 2;
+// Faces are 8-bit single-channel
+const uint32_t kRecordMagic = 0x31434552; // "REC1"
+// Every face carries its OpenCV type, e.g. color crops for SFace
+const uint32_t kTypedRecordMagic = 0x32434552; // "REC2"
+
+template <typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool getValue(const std::string& in, size_t& offset, T& value) {
+    if (offset + sizeof(value) > in.size()) return false;
+    std::memcpy(&value, in.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+// Read one length-prefixed record body; false on a torn or short record
+bool readRecord(std::ifstream& file, uintmax_t fileSize, uint32_t& magic, std::string& body) {
+    uint32_t length = 0;
+    if (!file.read(reinterpret_cast<char*>(&magic), sizeof(magic))) return false;
+    if (magic != kRecordMagic && magic != kTypedRecordMagic) return false;
+    if (!file.read(reinterpret_cast<char*>(&length), sizeof(length))) return false;
+    if (static_cast<uintmax_t>(file.tellg()) + length > fileSize) return false;
+
+    body.resize(length);
+    return static_cast<bool>(file.read(&body[0], length));
+}
+
+} // namespace
+
+GalleryJournal::GalleryJournal(const std::string& path) : path(path), records(0) {}
+
+bool GalleryJournal::append(const GalleryEntry& entry) {
+    if (path.empty()) {
+        return true;
+    }
+
+    // Gray faces keep the original record layout and file version, so
+    // journals written by the LBPH recognizer stay readable by older builds
+    bool typed = false;
+    for (const auto& face : entry.faces) {
+        if (face.depth() != CV_8U) {
+            return false;
+        }
+        typed = typed || face.type() != CV_8UC1;
+    }
+
+    // Serialize the whole record first so it reaches the file in one write
+    std::string body;
+    putValue<int32_t>(body, entry.label);
+    putValue<uint32_t>(body, static_cast<uint32_t>(entry.name.size()));
+    body.append(entry.name);
+    putValue<uint32_t>(body, static_cast<uint32_t>(entry.faces.size()));
+
+    for (const auto& face : entry.faces) {
+        cv::Mat continuous = face.isContinuous() ? face : face.clone();
+        putValue<uint32_t>(body, static_cast<uint32_t>(continuous.rows));
+        putValue<uint32_t>(body, static_cast<uint32_t>(continuous.cols));
+        if (typed) {
+            putValue<int32_t>(body, continuous.type());
+        }
+        body.append(reinterpret_cast<const char*>(continuous.data), continuous.total() * continuous.elemSize());
+    }
+
+    std::string record;
+    putValue<uint32_t>(record, typed ? kTypedRecordMagic : kRecordMagic);
+    putValue<uint32_t>(record, static_cast<uint32_t>(body.size() + sizeof(uint32_t)));
+    record.append(body);
+    putValue<uint32_t>(record, checksum(body));
+
+    bool isNew = true;
+    uint32_t version = 0;
+    {
+        std::ifstream existing(path, std::ios::binary | std::ios::ate);
+        isNew = !existing.is_open() || existing.tellg() <= 0;
+        if (!isNew) {
+            existing.seekg(sizeof(kFileMagic));
+            existing.read(reinterpret_cast<char*>(&version), sizeof(version));
+        }
+    }
+
+    // Raise the version before the first REC2 record lands, so an older
+    // build rejects the file instead of stopping at that record
+    uint32_t wanted = typed ? kTypedFileVersion : kFileVersion;
+    if (!isNew && version < wanted) {
+        std::fstream header(path, std::ios::binary | std::ios::in | std::ios::out);
+        header.seekp(sizeof(kFileMagic));
+        header.write(reinterpret_cast<const char*>(&wanted), sizeof(wanted));
+        header.flush();
+        if (!header) {
+            return false;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (isNew) {
+        file.write(kFileMagic, sizeof(kFileMagic));
+        file.write(reinterpret_cast<const char*>(&wanted), sizeof(wanted));
+    }
+    file.write(record.data(), record.size());
+    file.close();
+    if (!file) {
+        return false;
+    }
+
+    // Enrollments are rare, so each one is synced before it counts; a new
+    // journal also needs its directory entry to survive a power loss
+    if (!syncFile(path) || (isNew && !syncParentDirectory(path))) {
+        return false;
+    }
+    records++;
+    return true;
+}
+
+bool GalleryJournal::replay(const std::function<void(GalleryEntry&&)>& apply) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!file || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 || version < kFileVersion || version > kTypedFileVersion) {
+        return false;
+    }
+
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+
+    records = 0;
+    std::streamoff intactEnd = file.tellg();
+    uint32_t recordMagic = 0;
+    std::string body;
+    while (readRecord(file, fileSize, recordMagic, body)) {
+        if (body.size() < sizeof(uint32_t)) break;
+
+        // The trailing checksum covers everything before it
+        size_t payloadSize = body.size() - sizeof(uint32_t);
+        uint32_t stored = 0;
+        std::memcpy(&stored, body.data() + payloadSize, sizeof(stored));
+        body.resize(payloadSize);
+        if (stored != checksum(body)) break;
+
+        GalleryEntry entry;
+        size_t offset = 0;
+        int32_t label = 0;
+        uint32_t nameLength = 0;
+        uint32_t count = 0;
+
+        if (!getValue(body, offset, label) || !getValue(body, offset, nameLength)) break;
+        if (offset + nameLength > body.size()) break;
+        entry.label = label;
+        entry.name = body.substr(offset, nameLength);
+        offset += nameLength;
+        if (!getValue(body, offset, count)) break;
+
+        bool intact = true;
+        for (uint32_t i = 0; i < count && intact; ++i) {
+            uint32_t rows = 0;
+            uint32_t cols = 0;
+            int32_t type = CV_8UC1;
+            intact = getValue(body, offset, rows) && getValue(body, offset, cols) &&
+                     (recordMagic == kRecordMagic || getValue(body, offset, type)) &&
+                     CV_MAT_DEPTH(type) == CV_8U &&
+                     offset + static_cast<size_t>(rows) * cols * CV_MAT_CN(type) <= body.size();
+            if (intact) {
+                cv::Mat face(rows, cols, type);
+                size_t bytes = face.total() * face.elemSize();
+                std::memcpy(face.data, body.data() + offset, bytes);
+                offset += bytes;
+                entry.faces.push_back(face);
+            }
+        }
+        if (!intact) break;
+
+        apply(std::move(entry));
+        records++;
+        intactEnd = file.tellg();
+    }
+
+    // Cut off a torn tail so later appends stay reachable
+    file.close();
+    if (fileSize > static_cast<uintmax_t>(intactEnd)) {
+        std::filesystem::resize_file(path, static_cast<uintmax_t>(intactEnd), error);
+    }
+
+    return true;
+}
+
+bool GalleryJournal::truncate() {
+    if (path.empty()) {
+        return true;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    records = 0;
+    return file.is_open();
+}
+
+size_t GalleryJournal::recordCount() const {
+    return records;
+}
+
+void GalleryJournal::setPath(const std::string& path) {
+    this->path = path;
+    records = 0;
+}
+
+const std::string& GalleryJournal::getPath() const {
+    return path;
+}
+
+uint32_t GalleryJournal::checksum(const std::string& bytes) {
+    // FNV-1a, enough to spot torn or partially flushed records
+    uint32_t hash = 2166136261u;
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 16777619u;
+    }
+    return hash;
+}
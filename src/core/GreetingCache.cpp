@@ -0,0 +1,194 @@
+#include "../../include/core/GreetingCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'F', 'S', 'G', 'A'};
+const uint32_t kVersion = 1;
+const char* const kExtension = ".pcm";
+
+// Fixed-size clip header, written in host byte order
+struct Header {
+    char magic[4];
+    uint32_t version;
+    int32_t sampleRate;
+    int32_t speed;
+    int32_t pitch;
+    uint32_t nameLength;
+    uint64_t sampleCount;
+};
+
+// FNV-1a; names only need spreading over file names, collisions are caught
+// by the name stored in the file
+uint64_t hashName(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char byte : name) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Voice suffix of a cache file name, e.g. "_150_50.pcm"
+std::string voiceSuffix(int speed, int pitch) {
+    return "_" + std::to_string(speed) + "_" + std::to_string(pitch) + kExtension;
+}
+
+} // namespace
+
+GreetingCache::GreetingCache(const std::string& directory, size_t memoryClips)
+    : directory(directory), capacity(memoryClips > 0 ? memoryClips : 1) {}
+
+std::shared_ptr<const GreetingClip> GreetingCache::find(const std::string& name, int speed, int pitch) {
+    std::string clipKey = key(name, speed, pitch);
+    auto it = entries.find(clipKey);
+    if (it != entries.end()) {
+        recent.splice(recent.begin(), recent, it->second.recent);
+        return it->second.clip;
+    }
+
+    std::shared_ptr<const GreetingClip> clip = readClip(filePath(name, speed, pitch), name);
+    if (clip && clip->speed == speed && clip->pitch == pitch) {
+        remember(clipKey, clip);
+        return clip;
+    }
+    return nullptr;
+}
+
+bool GreetingCache::store(const std::string& name, std::shared_ptr<const GreetingClip> clip) {
+    if (!clip || clip->samples.empty()) {
+        return false;
+    }
+    remember(key(name, clip->speed, clip->pitch), clip);
+    return writeClip(filePath(name, clip->speed, clip->pitch), name, *clip);
+}
+
+void GreetingCache::invalidate(int speed, int pitch) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        const GreetingClip& clip = *it->second.clip;
+        if (clip.speed != speed || clip.pitch != pitch) {
+            recent.erase(it->second.recent);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Files of other voices would never be read again
+    std::error_code error;
+    std::string keep = voiceSuffix(speed, pitch);
+    for (fs::directory_iterator file(directory, error), end; !error && file != end; file.increment(error)) {
+        std::string filename = file->path().filename().string();
+        bool isClip = filename.size() > std::strlen(kExtension) &&
+            filename.compare(filename.size() - std::strlen(kExtension), std::strlen(kExtension), kExtension) == 0;
+        bool current = filename.size() > keep.size() &&
+            filename.compare(filename.size() - keep.size(), keep.size(), keep) == 0;
+        if (isClip && !current) {
+            std::error_code ignored;
+            fs::remove(file->path(), ignored);
+        }
+    }
+}
+
+size_t GreetingCache::size() const {
+    return entries.size();
+}
+
+void GreetingCache::remember(const std::string& clipKey, std::shared_ptr<const GreetingClip> clip) {
+    auto it = entries.find(clipKey);
+    if (it != entries.end()) {
+        it->second.clip = std::move(clip);
+        recent.splice(recent.begin(), recent, it->second.recent);
+        return;
+    }
+
+    recent.push_front(clipKey);
+    entries[clipKey] = Entry{std::move(clip), recent.begin()};
+    if (entries.size() > capacity) {
+        entries.erase(recent.back());
+        recent.pop_back();
+    }
+}
+
+std::string GreetingCache::filePath(const std::string& name, int speed, int pitch) const {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashName(name)));
+    return (fs::path(directory) / (hash + voiceSuffix(speed, pitch))).string();
+}
+
+std::string GreetingCache::key(const std::string& name, int speed, int pitch) {
+    return std::to_string(speed) + "/" + std::to_string(pitch) + "/" + name;
+}
+
+std::shared_ptr<const GreetingClip> GreetingCache::readClip(const std::string& path, const std::string& name) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.nameLength != name.size() || header.sampleRate <= 0) {
+        return nullptr;
+    }
+
+    std::string stored(header.nameLength, '\0');
+    if (!file.read(&stored[0], stored.size()) || stored != name) {
+        return nullptr;
+    }
+
+    // A clip is seconds of audio; anything far larger is a damaged header
+    if (header.sampleCount == 0 || header.sampleCount > static_cast<uint64_t>(header.sampleRate) * 60) {
+        return nullptr;
+    }
+
+    auto clip = std::make_shared<GreetingClip>();
+    clip->sampleRate = header.sampleRate;
+    clip->speed = header.speed;
+    clip->pitch = header.pitch;
+    clip->samples.resize(static_cast<size_t>(header.sampleCount));
+    if (!file.read(reinterpret_cast<char*>(clip->samples.data()), clip->samples.size() * sizeof(int16_t))) {
+        return nullptr;
+    }
+    return clip;
+}
+
+bool GreetingCache::writeClip(const std::string& path, const std::string& name, const GreetingClip& clip) {
+    std::error_code error;
+    fs::create_directories(fs::path(path).parent_path(), error);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sampleRate = clip.sampleRate;
+    header.speed = clip.speed;
+    header.pitch = clip.pitch;
+    header.nameLength = static_cast<uint32_t>(name.size());
+    header.sampleCount = clip.samples.size();
+
+    // Write beside the target and rename, so a reader never sees half a clip
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(name.data(), name.size());
+        file.write(reinterpret_cast<const char*>(clip.samples.data()), clip.samples.size() * sizeof(int16_t));
+        if (!file) {
+            fs::remove(temporary, error);
+            return false;
+        }
+    }
+
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,445 @@
+#include "../../include/core/HistogramMatcher.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FACESECURE_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define FACESECURE_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Floats scored between checks against the early-termination bound
+const size_t kBlock = 512;
+// Floats per 64-byte cache line
+const size_t kLineFloats = 16;
+// Galleries smaller than this are scanned on the calling thread
+const int kParallelRows = 256;
+
+// Distance of two padded rows, or any value above bound once the partial sum
+// exceeds it. Padding is zero on both sides and contributes 0.
+using Kernel = double (*)(const float* a, const float* b, size_t n, double bound);
+
+double chiSquareScalar(const float* a, const float* b, size_t n, double bound) {
+    double total = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        for (size_t i = block; i < end; ++i) {
+            double diff = static_cast<double>(a[i]) - b[i];
+            double sum = static_cast<double>(a[i]) + b[i];
+            if (sum > DBL_EPSILON) {
+                total += diff * diff / sum;
+            }
+        }
+        if (2.0 * total > bound) break;
+    }
+    return 2.0 * total;
+}
+
+// Cosine distance of two unit-length rows. Partial dot products say nothing
+// about the final value, so there is no early exit.
+double cosineScalar(const float* a, const float* b, size_t n, double) {
+    double dot = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        dot += static_cast<double>(a[i]) * b[i];
+    }
+    return 1.0 - dot;
+}
+
+// Euclidean distance, stopping once the partial sum of squares passes bound
+double euclideanScalar(const float* a, const float* b, size_t n, double bound) {
+    double limit = bound < DBL_MAX ? bound * bound : DBL_MAX;
+    double total = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        for (size_t i = block; i < end; ++i) {
+            double diff = static_cast<double>(a[i]) - b[i];
+            total += diff * diff;
+        }
+        if (total > limit) break;
+    }
+    return std::sqrt(total);
+}
+
+#ifdef FACESECURE_HAVE_AVX2
+// Sum of the eight lanes, in double
+__attribute__((target("avx2")))
+double horizontalSum(__m256 acc) {
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    __m256d wide = _mm256_cvtps_pd(half);
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(wide), _mm256_extractf128_pd(wide, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2")))
+double chiSquareAvx2(const float* a, const float* b, size_t n, double bound) {
+    const __m256 zero = _mm256_setzero_ps();
+    double total = 0.0;
+
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        // Float lanes per block, folded into a double between blocks
+        __m256 acc = zero;
+        for (size_t i = block; i < end; i += 8) {
+            __m256 va = _mm256_load_ps(a + i);
+            __m256 vb = _mm256_load_ps(b + i);
+            __m256 diff = _mm256_sub_ps(va, vb);
+            __m256 sum = _mm256_add_ps(va, vb);
+            // 0/0 on empty bins is NaN; the mask clears it
+            __m256 term = _mm256_div_ps(_mm256_mul_ps(diff, diff), sum);
+            acc = _mm256_add_ps(acc, _mm256_and_ps(term, _mm256_cmp_ps(sum, zero, _CMP_GT_OQ)));
+        }
+
+        total += horizontalSum(acc);
+
+        if (2.0 * total > bound) break;
+    }
+    return 2.0 * total;
+}
+
+__attribute__((target("avx2,fma")))
+double cosineAvx2(const float* a, const float* b, size_t n, double) {
+    double dot = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t i = block; i < end; i += 8) {
+            acc = _mm256_fmadd_ps(_mm256_load_ps(a + i), _mm256_load_ps(b + i), acc);
+        }
+        dot += horizontalSum(acc);
+    }
+    return 1.0 - dot;
+}
+
+__attribute__((target("avx2,fma")))
+double euclideanAvx2(const float* a, const float* b, size_t n, double bound) {
+    double limit = bound < DBL_MAX ? bound * bound : DBL_MAX;
+    double total = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t i = block; i < end; i += 8) {
+            __m256 diff = _mm256_sub_ps(_mm256_load_ps(a + i), _mm256_load_ps(b + i));
+            acc = _mm256_fmadd_ps(diff, diff, acc);
+        }
+        total += horizontalSum(acc);
+        if (total > limit) break;
+    }
+    return std::sqrt(total);
+}
+#endif
+
+#ifdef FACESECURE_HAVE_NEON
+double chiSquareNeon(const float* a, const float* b, size_t n, double bound) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    double total = 0.0;
+
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        float32x4_t acc = zero;
+        for (size_t i = block; i < end; i += 4) {
+            float32x4_t va = vld1q_f32(a + i);
+            float32x4_t vb = vld1q_f32(b + i);
+            float32x4_t diff = vsubq_f32(va, vb);
+            float32x4_t sum = vaddq_f32(va, vb);
+            float32x4_t term = vdivq_f32(vmulq_f32(diff, diff), sum);
+            uint32x4_t valid = vcgtq_f32(sum, zero);
+            acc = vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(term), valid)));
+        }
+
+        float64x2_t wide = vaddq_f64(vcvt_f64_f32(vget_low_f32(acc)), vcvt_high_f64_f32(acc));
+        total += vaddvq_f64(wide);
+
+        if (2.0 * total > bound) break;
+    }
+    return 2.0 * total;
+}
+
+double cosineNeon(const float* a, const float* b, size_t n, double) {
+    double dot = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (size_t i = block; i < end; i += 4) {
+            acc = vfmaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+        dot += vaddvq_f64(vaddq_f64(vcvt_f64_f32(vget_low_f32(acc)), vcvt_high_f64_f32(acc)));
+    }
+    return 1.0 - dot;
+}
+
+double euclideanNeon(const float* a, const float* b, size_t n, double bound) {
+    double limit = bound < DBL_MAX ? bound * bound : DBL_MAX;
+    double total = 0.0;
+    for (size_t block = 0; block < n; block += kBlock) {
+        size_t end = std::min(n, block + kBlock);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (size_t i = block; i < end; i += 4) {
+            float32x4_t diff = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+            acc = vfmaq_f32(acc, diff, diff);
+        }
+        total += vaddvq_f64(vaddq_f64(vcvt_f64_f32(vget_low_f32(acc)), vcvt_high_f64_f32(acc)));
+        if (total > limit) break;
+    }
+    return std::sqrt(total);
+}
+#endif
+
+// One kernel per metric, all for the same instruction set
+struct Kernels {
+    const char* name;
+    Kernel chiSquare;
+    Kernel cosine;
+    Kernel euclidean;
+};
+
+Kernels selectKernels() {
+#ifdef FACESECURE_HAVE_AVX2
+    if (cv::checkHardwareSupport(CV_CPU_AVX2) && cv::checkHardwareSupport(CV_CPU_FMA3)) {
+        return {"avx2", chiSquareAvx2, cosineAvx2, euclideanAvx2};
+    }
+#endif
+#ifdef FACESECURE_HAVE_NEON
+    return {"neon", chiSquareNeon, cosineNeon, euclideanNeon};
+#else
+    return {"scalar", chiSquareScalar, cosineScalar, euclideanScalar};
+#endif
+}
+
+// Picked on first use, so matchers constructed during static
+// initialization elsewhere still get a kernel
+const Kernels& activeKernels() {
+    static const Kernels kernels = selectKernels();
+    return kernels;
+}
+
+Kernel kernelFor(HistogramMatcher::Metric metric) {
+    switch (metric) {
+    case HistogramMatcher::Metric::Cosine: return activeKernels().cosine;
+    case HistogramMatcher::Metric::Euclidean: return activeKernels().euclidean;
+    case HistogramMatcher::Metric::ChiSquare: break;
+    }
+    return activeKernels().chiSquare;
+}
+
+// Lower bound to value if value is smaller
+void lowerBound(std::atomic<double>& bound, double value) {
+    double current = bound.load(std::memory_order_relaxed);
+    while (value < current && !bound.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+HistogramMatcher::HistogramMatcher()
+    : distanceMetric(Metric::ChiSquare), kernel(kernelFor(Metric::ChiSquare)), dims(0), stride(0), rows(nullptr),
+      removed(0) {}
+
+void HistogramMatcher::setMetric(Metric metric) {
+    distanceMetric = metric;
+    kernel = kernelFor(metric);
+}
+
+HistogramMatcher::Metric HistogramMatcher::metric() const {
+    return distanceMetric;
+}
+
+void HistogramMatcher::add(const cv::Mat& histogram, int label) {
+    cv::Mat row = histogram.reshape(1, 1);
+    if (row.type() != CV_32F) {
+        row.convertTo(row, CV_32F);
+    }
+    if (!row.isContinuous()) {
+        row = row.clone();
+    }
+
+    if (labels.empty()) {
+        dims = row.cols;
+        stride = rowStride(dims);
+    }
+    CV_Assert(row.cols == dims);
+    detach();
+
+    size_t offset = data.size();
+    data.resize(offset + stride, 0.0f);
+    std::memcpy(data.data() + offset, row.ptr<float>(), dims * sizeof(float));
+    rows = data.data();
+    labels.push_back(label);
+}
+
+void HistogramMatcher::clear() {
+    Buffer().swap(data);
+    owner.reset();
+    rows = nullptr;
+    labels.clear();
+    dims = 0;
+    stride = 0;
+    removed = 0;
+}
+
+void HistogramMatcher::attach(std::shared_ptr<const void> storage, const float* first, int dimensions,
+                              std::vector<int> rowLabels) {
+    CV_Assert(reinterpret_cast<uintptr_t>(first) % (kLineFloats * sizeof(float)) == 0);
+
+    clear();
+    owner = std::move(storage);
+    rows = first;
+    dims = dimensions;
+    stride = rowStride(dims);
+    labels = std::move(rowLabels);
+    removed = static_cast<size_t>(std::count_if(labels.begin(), labels.end(), [](int label) { return label < 0; }));
+}
+
+bool HistogramMatcher::isAttached() const {
+    return owner != nullptr;
+}
+
+void HistogramMatcher::detach() {
+    if (!owner) {
+        return;
+    }
+    data.assign(rows, rows + labels.size() * stride);
+    rows = data.data();
+    owner.reset();
+}
+
+size_t HistogramMatcher::rowStride(int dims) {
+    return (static_cast<size_t>(dims) + kLineFloats - 1) / kLineFloats * kLineFloats;
+}
+
+size_t HistogramMatcher::size() const {
+    return labels.size();
+}
+
+int HistogramMatcher::dimensions() const {
+    return dims;
+}
+
+int HistogramMatcher::labelAt(size_t index) const {
+    return labels[index];
+}
+
+cv::Mat HistogramMatcher::histogramAt(size_t index) const {
+    return cv::Mat(1, dims, CV_32F, const_cast<float*>(rows + index * stride));
+}
+
+HistogramMatcher::Match HistogramMatcher::nearest(const cv::Mat& query) const {
+    Match best;
+    if (labels.size() == removed || static_cast<int>(query.total()) != dims) {
+        return best;
+    }
+
+    // Aligned, zero-padded copy of the query
+    thread_local Buffer padded;
+    prepareQuery(query, padded);
+    // Workers must not name the thread_local themselves
+    const float* probe = padded.data();
+
+    int count = static_cast<int>(labels.size());
+    std::atomic<double> bound(DBL_MAX);
+    std::mutex mutex;
+
+    auto scan = [&](const cv::Range& range) {
+        Match local;
+        for (int r = range.start; r < range.end; ++r) {
+            if (labels[r] < 0) continue;
+
+            double distance = kernel(rows + r * stride, probe, stride,
+                bound.load(std::memory_order_relaxed));
+            if (distance < local.distance) {
+                local.index = r;
+                local.label = labels[r];
+                local.distance = distance;
+                lowerBound(bound, distance);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (local.distance < best.distance ||
+            (local.distance == best.distance && local.index >= 0 && local.index < best.index)) {
+            best = local;
+        }
+    };
+
+    if (count >= kParallelRows) {
+        cv::parallel_for_(cv::Range(0, count), scan, std::max(1, count / (kParallelRows / 4)));
+    } else {
+        scan(cv::Range(0, count));
+    }
+
+    return best;
+}
+
+void HistogramMatcher::prepareQuery(const cv::Mat& query, Buffer& padded) const {
+    cv::Mat row = query.reshape(1, 1);
+    if (row.type() != CV_32F) {
+        row.convertTo(row, CV_32F);
+    }
+    CV_Assert(row.cols == dims);
+
+    padded.assign(stride, 0.0f);
+    for (int i = 0; i < dims; ++i) {
+        padded[i] = row.at<float>(0, i);
+    }
+}
+
+double HistogramMatcher::distance(size_t index, const float* query, double bound) const {
+    return kernel(rows + index * stride, query, stride, bound);
+}
+
+const float* HistogramMatcher::rowData(size_t index) const {
+    return rows + index * stride;
+}
+
+std::vector<size_t> HistogramMatcher::removeLabel(int label) {
+    std::vector<size_t> dropped;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] == label) {
+            labels[i] = -1;
+            dropped.push_back(i);
+        }
+    }
+    removed += dropped.size();
+    return dropped;
+}
+
+bool HistogramMatcher::isRemoved(size_t index) const {
+    return labels[index] < 0;
+}
+
+size_t HistogramMatcher::removedCount() const {
+    return removed;
+}
+
+void HistogramMatcher::compact() {
+    if (removed == 0) {
+        return;
+    }
+    detach();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] < 0) continue;
+        if (kept != i) {
+            std::memmove(data.data() + kept * stride, data.data() + i * stride, stride * sizeof(float));
+            labels[kept] = labels[i];
+        }
+        kept++;
+    }
+    labels.resize(kept);
+    data.resize(kept * stride);
+    rows = data.data();
+    removed = 0;
+}
+
+const char* HistogramMatcher::kernelName() {
+    return activeKernels().name;
+}
@@ -0,0 +1,434 @@
+#include "../../include/core/HnswIndex.hpp"
+#include "../../include/core/FileSync.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <queue>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'F', 'S', 'H', 'N'};
+const uint32_t kVersion = 3;
+
+uint32_t fnv1a(const char* bytes, size_t length, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Identifies the labels an index was built over. The rows themselves are
+// identified by the snapshot's checksum, so loading never reads them.
+uint32_t labelFingerprint(const HistogramMatcher& store) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < store.size(); ++i) {
+        int label = store.labelAt(i);
+        hash = fnv1a(reinterpret_cast<const char*>(&label), sizeof(label), hash);
+    }
+    return hash;
+}
+
+template<typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool getValue(const std::string& in, size_t& offset, T& value) {
+    if (offset + sizeof(value) > in.size()) return false;
+    std::memcpy(&value, in.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+} // namespace
+
+HnswIndex::HnswIndex(const HistogramMatcher& store, const HnswConfig& config)
+    : store(store), config(config), lockCount(0), building(false), entryPoint(-1), maxLevel(-1), rng(0x5EED) {}
+
+void HnswIndex::insert(size_t row) {
+    CV_Assert(row == nodes.size() && row < store.size());
+
+    building = true;
+    allocate(row + 1);
+    link(static_cast<uint32_t>(row));
+    building = false;
+}
+
+void HnswIndex::build() {
+    size_t first = nodes.size();
+    if (first >= store.size()) {
+        return;
+    }
+
+    building = true;
+    allocate(store.size());
+    if (entryPoint < 0) {
+        link(static_cast<uint32_t>(first++));
+    }
+
+    cv::parallel_for_(cv::Range(static_cast<int>(first), static_cast<int>(store.size())), [this](const cv::Range& range) {
+        for (int id = range.start; id < range.end; ++id) {
+            link(static_cast<uint32_t>(id));
+        }
+    });
+    building = false;
+}
+
+void HnswIndex::markDeleted(size_t row) {
+    if (row < nodes.size()) {
+        nodes[row].deleted = true;
+    }
+}
+
+HistogramMatcher::Match HnswIndex::nearest(const float* query) const {
+    HistogramMatcher::Match best;
+
+    int64_t entry;
+    int top;
+    {
+        std::lock_guard<std::mutex> lock(entryLock);
+        entry = entryPoint;
+        top = maxLevel;
+    }
+    if (entry < 0) {
+        return best;
+    }
+
+    uint32_t current = descend(query, static_cast<uint32_t>(entry), top, 0);
+    for (const auto& candidate : searchLayer(query, current, std::max(1, config.efSearch), 0)) {
+        if (nodes[candidate.id].deleted) continue;
+
+        best.index = static_cast<int>(candidate.id);
+        best.label = store.labelAt(candidate.id);
+        best.distance = candidate.distance;
+        break;
+    }
+    return best;
+}
+
+size_t HnswIndex::size() const {
+    return nodes.size();
+}
+
+void HnswIndex::clear() {
+    nodes.clear();
+    nodeLocks.reset();
+    lockCount = 0;
+    entryPoint = -1;
+    maxLevel = -1;
+}
+
+void HnswIndex::setEfSearch(int ef) {
+    config.efSearch = std::max(1, ef);
+}
+
+const HnswConfig& HnswIndex::getConfig() const {
+    return config;
+}
+
+bool HnswIndex::save(const std::string& path, uint64_t rowsChecksum) const {
+    std::string bytes(kMagic, sizeof(kMagic));
+    putValue<uint32_t>(bytes, kVersion);
+    putValue<uint32_t>(bytes, static_cast<uint32_t>(config.M));
+    putValue<uint32_t>(bytes, static_cast<uint32_t>(config.efConstruction));
+    putValue<uint64_t>(bytes, nodes.size());
+    putValue<uint32_t>(bytes, static_cast<uint32_t>(store.dimensions()));
+    putValue<uint32_t>(bytes, labelFingerprint(store));
+    putValue<uint64_t>(bytes, rowsChecksum);
+    putValue<int64_t>(bytes, entryPoint);
+    putValue<int32_t>(bytes, maxLevel);
+
+    for (const auto& node : nodes) {
+        putValue<uint8_t>(bytes, node.deleted ? 1 : 0);
+        putValue<uint32_t>(bytes, static_cast<uint32_t>(node.links.size()));
+        for (const auto& links : node.links) {
+            putValue<uint32_t>(bytes, static_cast<uint32_t>(links.size()));
+            bytes.append(reinterpret_cast<const char*>(links.data()), links.size() * sizeof(uint32_t));
+        }
+    }
+    putValue<uint32_t>(bytes, fnv1a(bytes.data(), bytes.size()));
+
+    // Write beside the target and rename, so a crash never leaves half a graph
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = syncFile(file) && ok;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok) {
+        std::error_code error;
+        fs::remove(temporary, error);
+        return false;
+    }
+    return replaceFile(temporary, path);
+}
+
+bool HnswIndex::load(const std::string& path, uint64_t rowsChecksum) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < sizeof(kMagic) + sizeof(uint32_t) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    uint32_t stored = 0;
+    std::memcpy(&stored, bytes.data() + bytes.size() - sizeof(stored), sizeof(stored));
+    bytes.resize(bytes.size() - sizeof(stored));
+    if (fnv1a(bytes.data(), bytes.size()) != stored) {
+        return false;
+    }
+
+    size_t offset = sizeof(kMagic);
+    uint32_t version = 0, M = 0, efConstruction = 0, dims = 0, fingerprint = 0;
+    uint64_t count = 0, storedRows = 0;
+    int64_t entry = -1;
+    int32_t levels = -1;
+    if (!getValue(bytes, offset, version) || version != kVersion ||
+        !getValue(bytes, offset, M) || !getValue(bytes, offset, efConstruction) ||
+        !getValue(bytes, offset, count) || !getValue(bytes, offset, dims) ||
+        !getValue(bytes, offset, fingerprint) || !getValue(bytes, offset, storedRows) ||
+        !getValue(bytes, offset, entry) ||
+        !getValue(bytes, offset, levels)) {
+        return false;
+    }
+
+    // The graph is only valid for the exact rows it was built over
+    if (count != store.size() || static_cast<int>(dims) != store.dimensions() ||
+        fingerprint != labelFingerprint(store) || storedRows != rowsChecksum ||
+        entry >= static_cast<int64_t>(count)) {
+        return false;
+    }
+
+    std::vector<Node> loaded(count);
+    for (auto& node : loaded) {
+        uint8_t deleted = 0;
+        uint32_t nodeLevels = 0;
+        if (!getValue(bytes, offset, deleted) || !getValue(bytes, offset, nodeLevels) ||
+            nodeLevels > static_cast<uint32_t>(levels) + 1) {
+            return false;
+        }
+        node.deleted = deleted != 0;
+        node.links.resize(nodeLevels);
+        for (auto& links : node.links) {
+            uint32_t size = 0;
+            if (!getValue(bytes, offset, size) || offset + size * sizeof(uint32_t) > bytes.size()) {
+                return false;
+            }
+            links.resize(size);
+            std::memcpy(links.data(), bytes.data() + offset, size * sizeof(uint32_t));
+            offset += size * sizeof(uint32_t);
+            for (uint32_t id : links) {
+                if (id >= count) return false;
+            }
+        }
+    }
+
+    config.M = static_cast<int>(M);
+    config.efConstruction = static_cast<int>(efConstruction);
+    nodes = std::move(loaded);
+    nodeLocks.reset(new std::mutex[nodes.size()]);
+    lockCount = nodes.size();
+    entryPoint = entry;
+    maxLevel = levels;
+    return true;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::searchLayer(const float* query, uint32_t entry, int ef, int level) const {
+    // Visit marks are reused across searches by bumping an epoch
+    thread_local std::vector<uint32_t> visited;
+    thread_local uint32_t epoch = 0;
+    if (visited.size() < nodes.size()) {
+        visited.resize(nodes.size(), 0);
+    }
+    if (++epoch == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        epoch = 1;
+    }
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+    std::priority_queue<Candidate> results;
+
+    Candidate start{store.distance(entry, query), entry};
+    frontier.push(start);
+    results.push(start);
+    visited[entry] = epoch;
+
+    size_t limit = static_cast<size_t>(ef);
+    std::vector<uint32_t> scratch;
+    while (!frontier.empty()) {
+        Candidate closest = frontier.top();
+        if (closest.distance > results.top().distance && results.size() >= limit) {
+            break;
+        }
+        frontier.pop();
+
+        for (uint32_t neighbor : neighbors(closest.id, level, scratch)) {
+            if (visited[neighbor] == epoch) continue;
+            visited[neighbor] = epoch;
+
+            double bound = results.size() >= limit ? results.top().distance : DBL_MAX;
+            double d = store.distance(neighbor, query, bound);
+            if (results.size() < limit || d < results.top().distance) {
+                frontier.push({d, neighbor});
+                results.push({d, neighbor});
+                if (results.size() > limit) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> ordered(results.size());
+    for (size_t i = ordered.size(); i-- > 0;) {
+        ordered[i] = results.top();
+        results.pop();
+    }
+    return ordered;
+}
+
+std::vector<uint32_t> HnswIndex::selectNeighbors(const std::vector<Candidate>& candidates, size_t count) const {
+    std::vector<uint32_t> selected;
+    for (const auto& candidate : candidates) {
+        if (selected.size() >= count) break;
+
+        // Skip candidates already covered by a closer selected neighbor
+        bool diverse = true;
+        for (uint32_t other : selected) {
+            if (store.distance(other, store.rowData(candidate.id), candidate.distance) < candidate.distance) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) {
+            selected.push_back(candidate.id);
+        }
+    }
+    return selected;
+}
+
+void HnswIndex::shrinkLinks(uint32_t id, int level) {
+    // Called with the node's lock held
+    const float* origin = store.rowData(id);
+    std::vector<Candidate> candidates;
+    for (uint32_t neighbor : nodes[id].links[level]) {
+        candidates.push_back({store.distance(neighbor, origin), neighbor});
+    }
+    std::sort(candidates.begin(), candidates.end());
+    nodes[id].links[level] = selectNeighbors(candidates, maxLinks(level));
+}
+
+void HnswIndex::allocate(size_t count) {
+    size_t first = nodes.size();
+    nodes.resize(count);
+
+    // Mutexes cannot move, so grow the lock array geometrically
+    if (count > lockCount) {
+        lockCount = std::max(count, lockCount * 2);
+        nodeLocks.reset(new std::mutex[lockCount]);
+    }
+
+    // Levels come from one generator in row order, so builds are reproducible
+    for (size_t id = first; id < count; ++id) {
+        nodes[id].links.resize(randomLevel() + 1);
+        nodes[id].deleted = store.isRemoved(id);
+    }
+}
+
+void HnswIndex::link(uint32_t id) {
+    int level = static_cast<int>(nodes[id].links.size()) - 1;
+
+    // A node that becomes the new top holds the entry lock while linking,
+    // so no other insert descends from a half-connected entry point
+    std::unique_lock<std::mutex> topLock(entryLock);
+    int64_t entry = entryPoint;
+    int top = maxLevel;
+    if (entry < 0) {
+        entryPoint = id;
+        maxLevel = level;
+        return;
+    }
+    if (level <= top) {
+        topLock.unlock();
+    }
+
+    const float* query = store.rowData(id);
+    uint32_t current = descend(query, static_cast<uint32_t>(entry), top, level);
+
+    for (int l = std::min(level, top); l >= 0; --l) {
+        std::vector<Candidate> candidates = searchLayer(query, current, config.efConstruction, l);
+        std::vector<uint32_t> selected = selectNeighbors(candidates, static_cast<size_t>(config.M));
+        {
+            std::lock_guard<std::mutex> lock(nodeLocks[id]);
+            nodes[id].links[l] = selected;
+        }
+
+        for (uint32_t neighbor : selected) {
+            std::lock_guard<std::mutex> lock(nodeLocks[neighbor]);
+            nodes[neighbor].links[l].push_back(id);
+            if (nodes[neighbor].links[l].size() > maxLinks(l)) {
+                shrinkLinks(neighbor, l);
+            }
+        }
+        current = candidates.front().id;
+    }
+
+    if (level > top) {
+        entryPoint = id;
+        maxLevel = level;
+    }
+}
+
+const std::vector<uint32_t>& HnswIndex::neighbors(uint32_t id, int level, std::vector<uint32_t>& scratch) const {
+    // Links only change while the graph is being built; searches of a
+    // finished graph read them in place without locking
+    if (!building) {
+        return nodes[id].links[level];
+    }
+    std::lock_guard<std::mutex> lock(nodeLocks[id]);
+    scratch = nodes[id].links[level];
+    return scratch;
+}
+
+uint32_t HnswIndex::descend(const float* query, uint32_t entry, int fromLevel, int stopLevel) const {
+    uint32_t current = entry;
+    double currentDistance = store.distance(current, query);
+    std::vector<uint32_t> scratch;
+    for (int l = fromLevel; l > stopLevel; --l) {
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            for (uint32_t neighbor : neighbors(current, l, scratch)) {
+                double d = store.distance(neighbor, query, currentDistance);
+                if (d < currentDistance) {
+                    current = neighbor;
+                    currentDistance = d;
+                    moved = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+int HnswIndex::randomLevel() {
+    std::uniform_real_distribution<double> uniform(std::nextafter(0.0, 1.0), 1.0);
+    double scale = 1.0 / std::log(static_cast<double>(std::max(2, config.M)));
+    return static_cast<int>(-std::log(uniform(rng)) * scale);
+}
+
+size_t HnswIndex::maxLinks(int level) const {
+    return static_cast<size_t>(level == 0 ? 2 * config.M : config.M);
+}
@@ -0,0 +1,109 @@
+#include "../../include/core/IdentityVoter.hpp"
+#include <algorithm>
+
+IdentityVoter::IdentityVoter(const VoterConfig& config)
+    : config(config), committedCount(0) {}
+
+bool IdentityVoter::observe(int trackId, const std::string& name, double confidence) {
+    TrackVotes& state = tracks[trackId];
+
+    // Confidence is scaled so that 100 is the recognizer's acceptance limit
+    Vote vote;
+    vote.name = name;
+    vote.strength = std::max(0.0, std::min(1.0, 1.0 - confidence / 100.0));
+    state.votes.push_back(std::move(vote));
+    while (state.votes.size() > std::max<size_t>(1, config.window)) {
+        state.votes.pop_front();
+    }
+
+    // Fast path: the two latest recognitions name the same person and both
+    // match closely
+    std::string decided;
+    size_t count = state.votes.size();
+    if (count >= 2) {
+        const Vote& latest = state.votes[count - 1];
+        const Vote& previous = state.votes[count - 2];
+        if (latest.name != "Unknown" && latest.name == previous.name &&
+            std::min(latest.strength, previous.strength) >= config.strongMatch) {
+            decided = latest.name;
+        }
+    }
+
+    // Otherwise a name needs a strict majority of the window, so a tie is
+    // never a decision; "Unknown" only counts against the others
+    if (decided.empty()) {
+        std::map<std::string, int> counts;
+        for (const auto& entry : state.votes) {
+            if (entry.name != "Unknown") {
+                counts[entry.name]++;
+            }
+        }
+        for (const auto& entry : counts) {
+            double share = static_cast<double>(entry.second) / count;
+            if (entry.second >= config.minVotes && 2 * static_cast<size_t>(entry.second) > count &&
+                share >= config.requiredShare) {
+                decided = entry.first;
+            }
+        }
+    }
+
+    if (decided.empty() || decided == state.committed) {
+        return false;
+    }
+    state.committed = decided;
+
+    auto now = std::chrono::steady_clock::now();
+    auto previous = lastCommit.find(state.committed);
+    if (previous != lastCommit.end() && now - previous->second < config.recommitAfter) {
+        return false;
+    }
+    lastCommit[state.committed] = now;
+    committedCount++;
+    return true;
+}
+
+bool IdentityVoter::wantsEvidence(int trackId) const {
+    auto found = tracks.find(trackId);
+    if (found == tracks.end()) {
+        return false;
+    }
+
+    // A full window without agreement is left to the tracker's schedule
+    const TrackVotes& state = found->second;
+    if (!state.committed.empty() || state.votes.size() >= config.window) {
+        return false;
+    }
+    return std::any_of(state.votes.begin(), state.votes.end(),
+        [](const Vote& vote) { return vote.name != "Unknown"; });
+}
+
+std::string IdentityVoter::committedName(int trackId) const {
+    auto found = tracks.find(trackId);
+    return found != tracks.end() ? found->second.committed : std::string();
+}
+
+void IdentityVoter::retain(const std::vector<Track>& live) {
+    for (auto it = tracks.begin(); it != tracks.end();) {
+        bool alive = std::any_of(live.begin(), live.end(),
+            [&](const Track& track) { return track.id == it->first; });
+        it = alive ? std::next(it) : tracks.erase(it);
+    }
+}
+
+uint64_t IdentityVoter::commits() const {
+    return committedCount;
+}
+
+void IdentityVoter::reset() {
+    tracks.clear();
+    lastCommit.clear();
+    committedCount = 0;
+}
+
+void IdentityVoter::setConfig(const VoterConfig& config) {
+    this->config = config;
+}
+
+double IdentityVoter::shareForThreshold(int threshold) {
+    return 0.5 + 0.5 * std::max(0, std::min(100, threshold)) / 100.0;
+}
@@ -0,0 +1,117 @@
+#include "../../include/core/LbphBackend.hpp"
+#include "../../include/core/FaceRecognizer.hpp"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Circular LBP codes computed exactly as the face module's elbp(): the
+// same bilinear sampling in float and the same rule for ties, so the
+// histograms match LBPHFaceRecognizer bit for bit
+cv::Mat lbpCodes(const cv::Mat& src, int radius, int neighbors) {
+    cv::Mat codes = cv::Mat::zeros(src.rows - 2 * radius, src.cols - 2 * radius, CV_32SC1);
+    for (int n = 0; n < neighbors; ++n) {
+        float x = static_cast<float>(radius * std::cos(2.0 * CV_PI * n / static_cast<float>(neighbors)));
+        float y = static_cast<float>(-radius * std::sin(2.0 * CV_PI * n / static_cast<float>(neighbors)));
+        int fx = static_cast<int>(std::floor(x));
+        int fy = static_cast<int>(std::floor(y));
+        int cx = static_cast<int>(std::ceil(x));
+        int cy = static_cast<int>(std::ceil(y));
+        float ty = y - fy;
+        float tx = x - fx;
+        float w1 = (1 - tx) * (1 - ty);
+        float w2 = tx * (1 - ty);
+        float w3 = (1 - tx) * ty;
+        float w4 = tx * ty;
+
+        for (int i = radius; i < src.rows - radius; ++i) {
+            const uchar* center = src.ptr<uchar>(i);
+            const uchar* upper = src.ptr<uchar>(i + fy);
+            const uchar* lower = src.ptr<uchar>(i + cy);
+            int* out = codes.ptr<int>(i - radius);
+            for (int j = radius; j < src.cols - radius; ++j) {
+                float t = static_cast<float>(w1 * upper[j + fx] + w2 * upper[j + cx] + w3 * lower[j + fx] + w4 * lower[j + cx]);
+                bool set = t > center[j] || std::abs(t - center[j]) < std::numeric_limits<float>::epsilon();
+                out[j - radius] += static_cast<int>(set) << n;
+            }
+        }
+    }
+    return codes;
+}
+
+// Normalized code histogram of every grid cell, concatenated into one row,
+// as the face module's spatial_histogram()
+cv::Mat spatialHistogram(const cv::Mat& codes, int patterns, int gridX, int gridY) {
+    cv::Mat result = cv::Mat::zeros(1, gridX * gridY * patterns, CV_32FC1);
+    int width = codes.cols / gridX;
+    int height = codes.rows / gridY;
+    int cellSize = width * height;
+    if (cellSize == 0) {
+        return result;
+    }
+
+    float* bins = result.ptr<float>();
+    for (int i = 0; i < gridY; ++i) {
+        for (int j = 0; j < gridX; ++j, bins += patterns) {
+            for (int row = i * height; row < (i + 1) * height; ++row) {
+                const int* code = codes.ptr<int>(row) + j * width;
+                for (int col = 0; col < width; ++col) {
+                    if (code[col] >= 0 && code[col] < patterns) {
+                        bins[code[col]] += 1.0f;
+                    }
+                }
+            }
+            for (int b = 0; b < patterns; ++b) {
+                bins[b] /= cellSize;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+LbphBackend::LbphBackend() : model(cv::face::LBPHFaceRecognizer::create()) {}
+
+RecognizerType LbphBackend::type() const {
+    return RecognizerType::Lbph;
+}
+
+cv::Mat LbphBackend::preprocess(const cv::Mat& faceImage) const {
+    return FaceRecognizer::preprocessFace(faceImage);
+}
+
+cv::Mat LbphBackend::describe(const cv::Mat& processed) const {
+    int radius = model->getRadius();
+    if (processed.type() != CV_8UC1 || processed.rows <= 2 * radius || processed.cols <= 2 * radius) {
+        return cv::Mat();
+    }
+
+    int neighbors = model->getNeighbors();
+    cv::Mat codes = lbpCodes(processed, radius, neighbors);
+    return spatialHistogram(codes, 1 << neighbors, model->getGridX(), model->getGridY());
+}
+
+HistogramMatcher::Metric LbphBackend::metric() const {
+    return HistogramMatcher::Metric::ChiSquare;
+}
+
+double LbphBackend::acceptDistance() const {
+    return 100.0;
+}
+
+GalleryParams LbphBackend::galleryParams() const {
+    GalleryParams params;
+    params.radius = model->getRadius();
+    params.neighbors = model->getNeighbors();
+    params.gridX = model->getGridX();
+    params.gridY = model->getGridY();
+    params.threshold = model->getThreshold();
+    params.recognizer = static_cast<int>(RecognizerType::Lbph);
+    return params;
+}
+
+void LbphBackend::setGalleryParams(const GalleryParams& params) {
+    model = cv::face::LBPHFaceRecognizer::create(params.radius, params.neighbors,
+        params.gridX, params.gridY, params.threshold);
+}
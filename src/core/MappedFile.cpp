@@ -0,0 +1,130 @@
+#include "../../include/core/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : base(nullptr), length(0), file(nullptr), mapping(nullptr) {}
+
+#else
+
+MappedFile::MappedFile() : base(nullptr), length(0) {}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    // FILE_SHARE_DELETE lets a writer rename a new snapshot over this one
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE section = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!section) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    void* view = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(section);
+        CloseHandle(handle);
+        return false;
+    }
+
+    file = handle;
+    mapping = section;
+    base = static_cast<const char*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file) {
+        CloseHandle(file);
+    }
+    base = nullptr;
+    length = 0;
+    file = nullptr;
+    mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file alive; the descriptor is not needed after
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    base = static_cast<const char*>(view);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) {
+        munmap(const_cast<char*>(base), length);
+    }
+    base = nullptr;
+    length = 0;
+}
+
+#endif
+
+bool MappedFile::isOpen() const {
+    return base != nullptr;
+}
+
+const char* MappedFile::data() const {
+    return base;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
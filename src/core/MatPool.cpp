@@ -0,0 +1,131 @@
+#include "../../include/core/MatPool.hpp"
+
+namespace {
+
+// Step value meaning "compute it" (CV_AUTOSTEP in the C API headers)
+const size_t kAutoStep = 0x7fffffff;
+
+} // namespace
+
+MatPool& MatPool::shared() {
+    static MatPool* pool = new MatPool();
+    return *pool;
+}
+
+cv::Mat& MatPool::usePool(cv::Mat& mat) {
+    if (mat.empty()) {
+        mat.allocator = &shared();
+    }
+    return mat;
+}
+
+MatPool::MatPool(size_t maxPerSize, size_t maxCachedBytes)
+    : maxPerSize(maxPerSize),
+      maxCachedBytes(maxCachedBytes),
+      cachedBuffers(0),
+      cachedBytes(0),
+      allocations(0),
+      reuses(0),
+      frees(0) {}
+
+MatPoolStats MatPool::stats() const {
+    MatPoolStats result;
+    result.allocations = allocations;
+    result.reuses = reuses;
+    result.frees = frees;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    result.cachedBuffers = cachedBuffers;
+    result.cachedBytes = cachedBytes;
+    return result;
+}
+
+void MatPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : freeLists) {
+        for (uchar* buffer : entry.second) {
+            cv::fastFree(buffer);
+        }
+    }
+    freeLists.clear();
+    cachedBuffers = 0;
+    cachedBytes = 0;
+}
+
+// Same bookkeeping as OpenCV's default allocator; only where the bytes come
+// from and go back to differs
+cv::UMatData* MatPool::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                cv::AccessFlag, cv::UMatUsageFlags) const {
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != kAutoStep) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data ? static_cast<uchar*>(data) : acquire(total);
+    u->size = total;
+    if (data) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool MatPool::allocate(cv::UMatData* data, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return data != nullptr;
+}
+
+void MatPool::deallocate(cv::UMatData* data) const {
+    if (!data) {
+        return;
+    }
+
+    CV_Assert(data->urefcount == 0);
+    CV_Assert(data->refcount == 0);
+    if (!(data->flags & cv::UMatData::USER_ALLOCATED)) {
+        release(data->origdata, data->size);
+        data->origdata = nullptr;
+    }
+    delete data;
+}
+
+uchar* MatPool::acquire(size_t bytes) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = freeLists.find(bytes);
+        if (it != freeLists.end() && !it->second.empty()) {
+            uchar* buffer = it->second.back();
+            it->second.pop_back();
+            cachedBuffers--;
+            cachedBytes -= bytes;
+            reuses++;
+            return buffer;
+        }
+    }
+
+    allocations++;
+    return static_cast<uchar*>(cv::fastMalloc(bytes));
+}
+
+void MatPool::release(uchar* buffer, size_t bytes) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uchar*>& list = freeLists[bytes];
+        if (list.size() < maxPerSize && cachedBytes + bytes <= maxCachedBytes) {
+            list.push_back(buffer);
+            cachedBuffers++;
+            cachedBytes += bytes;
+            return;
+        }
+    }
+
+    frees++;
+    cv::fastFree(buffer);
+}
@@ -0,0 +1,61 @@
+#include "../../include/core/MotionGate.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+MotionGate::MotionGate(const MotionGateConfig& config)
+    : config(config), sinceDetection(0) {}
+
+bool MotionGate::shouldDetect(const cv::Mat& frame) {
+    if (!config.enabled || frame.empty()) {
+        return true;
+    }
+
+    double scale = std::min(1.0, static_cast<double>(config.analysisWidth) / frame.cols);
+    // Separate color and gray buffers: an in-place conversion would
+    // reallocate both every frame
+    if (frame.channels() == 3) {
+        cv::resize(frame, smallColor, cv::Size(), scale, scale, cv::INTER_AREA);
+        cv::cvtColor(smallColor, small, cv::COLOR_BGR2GRAY);
+    } else {
+        cv::resize(frame, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    // Blur away sensor noise so it does not register as motion
+    cv::GaussianBlur(small, small, cv::Size(5, 5), 0);
+
+    if (background.empty() || background.size() != small.size()) {
+        small.convertTo(background, CV_32F);
+        sinceDetection = 0;
+        return true;
+    }
+
+    background.convertTo(reference, CV_8U);
+    cv::absdiff(small, reference, difference);
+    cv::threshold(difference, difference, config.pixelThreshold, 255, cv::THRESH_BINARY);
+    int changed = cv::countNonZero(difference);
+
+    cv::accumulateWeighted(small, background, config.backgroundRate);
+
+    bool moving = changed >= config.changedFraction * small.total();
+    if (moving || ++sinceDetection >= config.refreshInterval) {
+        sinceDetection = 0;
+        return true;
+    }
+
+    return false;
+}
+
+void MotionGate::reset() {
+    background.release();
+    sinceDetection = 0;
+}
+
+void MotionGate::setConfig(const MotionGateConfig& config) {
+    this->config = config;
+    background.release();
+}
+
+double MotionGate::fractionForSensitivity(int sensitivity) {
+    // 100 reacts to a few pixels, 1 needs about 1% of the frame to change
+    int clamped = std::max(1, std::min(100, sensitivity));
+    return (101 - clamped) / 10000.0;
+}
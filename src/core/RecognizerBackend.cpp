@@ -0,0 +1,77 @@
+#include "../../include/core/RecognizerBackend.hpp"
+#include "../../include/core/LbphBackend.hpp"
+#include "../../include/core/SFaceBackend.hpp"
+#include "../../include/core/SubspaceBackend.hpp"
+
+GalleryParams RecognizerBackend::galleryParams() const {
+    GalleryParams params;
+    params.recognizer = static_cast<int>(type());
+    return params;
+}
+
+std::shared_ptr<RecognizerBackend> RecognizerBackend::create(RecognizerType type, const std::string& modelFile) {
+    switch (type) {
+    case RecognizerType::Lbph:
+        return std::make_shared<LbphBackend>();
+    case RecognizerType::Eigenfaces:
+    case RecognizerType::Fisherfaces:
+        return std::make_shared<SubspaceBackend>(type);
+    case RecognizerType::SFace: {
+        auto network = std::make_shared<SFaceBackend>();
+        if (!network->load(modelFile.empty() ? defaultModelFile(type) : modelFile)) {
+            return nullptr;
+        }
+        return network;
+    }
+    }
+    return nullptr;
+}
+
+const char* RecognizerBackend::defaultModelFile(RecognizerType type) {
+    return type == RecognizerType::SFace ? "data/face_recognition_sface_2021dec.onnx" : "";
+}
+
+const char* RecognizerBackend::defaultGalleryFile(RecognizerType type) {
+    switch (type) {
+    case RecognizerType::Lbph: return "data/trained_model.gallery";
+    // Subspace models and their training faces only fit the YAML layout
+    case RecognizerType::Eigenfaces: return "data/trained_model_eigenfaces.yml";
+    case RecognizerType::Fisherfaces: return "data/trained_model_fisherfaces.yml";
+    case RecognizerType::SFace: return "data/trained_model_sface.gallery";
+    }
+    return "";
+}
+
+const char* RecognizerBackend::defaultJournalFile(RecognizerType type) {
+    switch (type) {
+    case RecognizerType::Lbph: return "data/gallery.journal";
+    case RecognizerType::Eigenfaces: return "data/gallery_eigenfaces.journal";
+    case RecognizerType::Fisherfaces: return "data/gallery_fisherfaces.journal";
+    case RecognizerType::SFace: return "data/gallery_sface.journal";
+    }
+    return "";
+}
+
+const char* RecognizerBackend::typeName(RecognizerType type) {
+    switch (type) {
+    case RecognizerType::Lbph: return "lbph";
+    case RecognizerType::Eigenfaces: return "eigenfaces";
+    case RecognizerType::Fisherfaces: return "fisherfaces";
+    case RecognizerType::SFace: return "sface";
+    }
+    return "";
+}
+
+bool RecognizerBackend::parseType(const std::string& name, RecognizerType& type) {
+    for (RecognizerType candidate : allTypes()) {
+        if (name == typeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<RecognizerType> RecognizerBackend::allTypes() {
+    return {RecognizerType::Lbph, RecognizerType::Eigenfaces, RecognizerType::Fisherfaces, RecognizerType::SFace};
+}
@@ -0,0 +1,95 @@
+#include "../../include/core/SFaceBackend.hpp"
+#include "../../include/core/MatPool.hpp"
+#include <opencv2/imgproc.hpp>
+
+namespace {
+
+const cv::Size kInput(112, 112);
+// 1 - 0.363, the cosine similarity SFace is published with
+const double kAcceptDistance = 0.637;
+
+} // namespace
+
+SFaceBackend::SFaceBackend() : networks([this]() { return createNetwork(); }) {}
+
+bool SFaceBackend::load(const std::string& model) {
+    modelFile = model;
+
+    std::unique_ptr<cv::dnn::Net> first = createNetwork();
+    if (!first) {
+        return false;
+    }
+
+    // One forward pass on a blank face, so a file that parses but does not
+    // run fails here rather than during recognition
+    try {
+        if (embed(*first, cv::Mat(kInput, CV_8UC3, cv::Scalar::all(0))).empty()) {
+            return false;
+        }
+    } catch (const cv::Exception&) {
+        return false;
+    }
+
+    networks.add(std::move(first));
+    return true;
+}
+
+RecognizerType SFaceBackend::type() const {
+    return RecognizerType::SFace;
+}
+
+cv::Mat SFaceBackend::preprocess(const cv::Mat& faceImage) const {
+    cv::Mat processed;
+    MatPool::usePool(processed);
+    if (faceImage.channels() == 1) {
+        thread_local cv::Mat resized;
+        cv::resize(faceImage, resized, kInput, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(resized, processed, cv::COLOR_GRAY2BGR);
+    } else {
+        cv::resize(faceImage, processed, kInput, 0, 0, cv::INTER_AREA);
+    }
+    return processed;
+}
+
+cv::Mat SFaceBackend::describe(const cv::Mat& processed) const {
+    InstancePool<cv::dnn::Net>::Lease network = networks.acquire();
+    if (!network || processed.empty()) {
+        return cv::Mat();
+    }
+    return embed(*network, processed);
+}
+
+HistogramMatcher::Metric SFaceBackend::metric() const {
+    return HistogramMatcher::Metric::Cosine;
+}
+
+double SFaceBackend::acceptDistance() const {
+    return kAcceptDistance;
+}
+
+std::unique_ptr<cv::dnn::Net> SFaceBackend::createNetwork() const {
+    auto network = std::make_unique<cv::dnn::Net>();
+    try {
+        *network = cv::dnn::readNetFromONNX(modelFile);
+        if (network->empty()) {
+            return nullptr;
+        }
+        network->setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        network->setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    } catch (const cv::Exception&) {
+        return nullptr;
+    }
+    return network;
+}
+
+cv::Mat SFaceBackend::embed(cv::dnn::Net& network, const cv::Mat& processed) {
+    // Same blob cv::FaceRecognizerSF::feature builds: RGB, no scaling or mean
+    cv::Mat blob = cv::dnn::blobFromImage(processed, 1.0, kInput, cv::Scalar(), true, false);
+    network.setInput(blob);
+    cv::Mat output = network.forward();
+
+    // Unit length, so cosine distance is one minus the dot product
+    cv::Mat embedding;
+    cv::normalize(output.reshape(1, 1), embedding);
+    return embedding;
+}
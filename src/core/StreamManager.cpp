@@ -0,0 +1,97 @@
+#include "../../include/core/StreamManager.hpp"
+#include <thread>
+
+StreamManager::StreamManager(FaceRecognizer& recognizer) : recognizer(recognizer) {}
+
+StreamManager::~StreamManager() {
+    stop();
+}
+
+bool StreamManager::start(const StreamOptions& options, ResultCallback onResult, FinishedCallback onFinished) {
+    stop();
+    streams.clear();
+
+    // Core 0 is left to capture and the GUI; each stream pins its detect and
+    // recognize stages to the next two cores. With more streams than that
+    // the scheduler places the threads instead.
+    unsigned cores = std::thread::hardware_concurrency();
+    bool pin = options.pipeline.pinThreads && cores >= 1 + 2 * options.sources.size();
+
+    // Every stream detects through the same backend
+    std::shared_ptr<DetectorBackend> backend = options.detector;
+    if (!backend) {
+        backend = DetectorBackend::create(DetectorType::HaarCascade, options.cascadeFile);
+        if (!backend) {
+            return false;
+        }
+    }
+
+    bool anyStarted = false;
+    for (size_t i = 0; i < options.sources.size(); ++i) {
+        auto stream = std::make_unique<Stream>(recognizer);
+        stream->source = options.sources[i];
+
+        if (stream->detector.initialize(backend)) {
+            stream->detector.setMinFaceSize(options.minFaceSize);
+            stream->detector.setCoarseToFine(options.coarseToFine);
+
+            PipelineConfig config = options.pipeline;
+            config.source = stream->source;
+            config.pinThreads = pin;
+            config.firstCore = static_cast<unsigned>(1 + 2 * i);
+
+            bool started = stream->pipeline.start(config,
+                [onResult, i](FrameResult&& result) {
+                    if (onResult) {
+                        onResult(i, std::move(result));
+                    }
+                },
+                [onFinished, i]() {
+                    if (onFinished) {
+                        onFinished(i);
+                    }
+                });
+            anyStarted = anyStarted || started;
+        }
+        streams.push_back(std::move(stream));
+    }
+    return anyStarted;
+}
+
+void StreamManager::stop() {
+    for (auto& stream : streams) {
+        stream->pipeline.stop();
+    }
+}
+
+bool StreamManager::isRunning() const {
+    for (const auto& stream : streams) {
+        if (stream->pipeline.isRunning()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t StreamManager::streamCount() const {
+    return streams.size();
+}
+
+StreamStats StreamManager::stats(size_t stream) const {
+    StreamStats result;
+    if (stream >= streams.size()) {
+        return result;
+    }
+
+    const FramePipeline& pipeline = streams[stream]->pipeline;
+    result.source = streams[stream]->source;
+    result.running = pipeline.isRunning();
+    result.frames = pipeline.processedFrames();
+    result.droppedFrames = pipeline.droppedFrames();
+    result.recognizerCalls = pipeline.recognizerCalls();
+    result.skippedDetections = pipeline.skippedDetections();
+    result.faceQuality = pipeline.faceQualityStats();
+    result.identityCommits = pipeline.identityCommits();
+    result.detectMs = streams[stream]->detector.getStats().meanMs;
+    return result;
+}
@@ -0,0 +1,104 @@
+#include "../../include/core/SubspaceBackend.hpp"
+#include "../../include/core/FaceRecognizer.hpp"
+
+namespace {
+
+// Projection distances of 100x100 faces at which matches become
+// unreliable; Fisherfaces separates identities in far fewer dimensions
+const double kEigenfacesAccept = 4000.0;
+const double kFisherfacesAccept = 800.0;
+
+} // namespace
+
+SubspaceBackend::SubspaceBackend(RecognizerType type) : subspaceType(type), model(createModel()) {}
+
+RecognizerType SubspaceBackend::type() const {
+    return subspaceType;
+}
+
+cv::Mat SubspaceBackend::preprocess(const cv::Mat& faceImage) const {
+    return FaceRecognizer::preprocessFace(faceImage);
+}
+
+cv::Mat SubspaceBackend::describe(const cv::Mat& processed) const {
+    if (eigenvectors.empty()) {
+        return cv::Mat();
+    }
+
+    // The same projection BasicFaceRecognizer::predict applies to a query
+    cv::Mat projection = cv::LDA::subspaceProject(eigenvectors, mean, processed.reshape(1, 1));
+    cv::Mat row;
+    projection.convertTo(row, CV_32F);
+    return row;
+}
+
+HistogramMatcher::Metric SubspaceBackend::metric() const {
+    return HistogramMatcher::Metric::Euclidean;
+}
+
+double SubspaceBackend::acceptDistance() const {
+    return subspaceType == RecognizerType::Fisherfaces ? kFisherfacesAccept : kEigenfacesAccept;
+}
+
+bool SubspaceBackend::isTrainable() const {
+    return true;
+}
+
+bool SubspaceBackend::train(const std::vector<cv::Mat>& processed, const std::vector<int>& labels) {
+    eigenvectors.release();
+    mean.release();
+    if (processed.empty()) {
+        return false;
+    }
+
+    // Training from scratch every time; neither recognizer supports update()
+    cv::Ptr<cv::face::BasicFaceRecognizer> trained = createModel();
+    try {
+        trained->train(processed, labels);
+    } catch (const cv::Exception&) {
+        // Fisherfaces needs at least two identities
+        return false;
+    }
+
+    model = trained;
+    eigenvectors = model->getEigenVectors();
+    mean = model->getMean();
+    return true;
+}
+
+void SubspaceBackend::write(cv::FileStorage& fs) const {
+    if (!eigenvectors.empty()) {
+        model->write(fs);
+    }
+}
+
+bool SubspaceBackend::read(const cv::FileNode& node) {
+    eigenvectors.release();
+    mean.release();
+    if (node.empty()) {
+        // Saved before any training succeeded
+        return true;
+    }
+
+    cv::Ptr<cv::face::BasicFaceRecognizer> loaded = createModel();
+    try {
+        loaded->read(node);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+    if (loaded->empty()) {
+        return false;
+    }
+
+    model = loaded;
+    eigenvectors = model->getEigenVectors();
+    mean = model->getMean();
+    return true;
+}
+
+cv::Ptr<cv::face::BasicFaceRecognizer> SubspaceBackend::createModel() const {
+    if (subspaceType == RecognizerType::Fisherfaces) {
+        return cv::face::FisherFaceRecognizer::create();
+    }
+    return cv::face::EigenFaceRecognizer::create();
+}
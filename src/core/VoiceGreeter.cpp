@@ -1,31 +1,301 @@
 #include "../../include/core/VoiceGreeter.hpp"
-#include <cstdlib>
-#include <sstream>
+#include <espeak/speak_lib.h>
+#include <algorithm>
 
-VoiceGreeter::VoiceGreeter() : speed(150), pitch(50), initialized(false) {}
+#ifdef FACESECURE_HAVE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+namespace {
+
+// ALSA device the cached clips are played on. Without ALSA it never opens
+// and espeak plays greetings itself.
+class PcmOutput {
+public:
+    PcmOutput() = default;
+    ~PcmOutput() { close(); }
+    
+    PcmOutput(const PcmOutput&) = delete;
+    PcmOutput& operator=(const PcmOutput&) = delete;
+    
+    bool open() {
+#ifdef FACESECURE_HAVE_ALSA
+        return snd_pcm_open(&device, "default", SND_PCM_STREAM_PLAYBACK, 0) == 0;
+#else
+        return false;
+#endif
+    }
+    
+    // Mono 16-bit at the given rate, with 100 ms of buffering
+    bool configure(int sampleRate) {
+#ifdef FACESECURE_HAVE_ALSA
+        return device && snd_pcm_set_params(device, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED, 1,
+            static_cast<unsigned int>(sampleRate), 1, 100000) == 0;
+#else
+        (void)sampleRate;
+        return false;
+#endif
+    }
+    
+    // Play a whole clip and wait until it has been heard
+    bool play(const std::vector<int16_t>& samples) {
+#ifdef FACESECURE_HAVE_ALSA
+        if (!device) return false;
+        size_t offset = 0;
+        while (offset < samples.size()) {
+            snd_pcm_sframes_t written = snd_pcm_writei(device, samples.data() + offset, samples.size() - offset);
+            if (written < 0) {
+                // Underruns and suspends are recoverable; anything else is not
+                if (snd_pcm_recover(device, static_cast<int>(written), 1) < 0) return false;
+                continue;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        snd_pcm_drain(device);
+        snd_pcm_prepare(device);
+        return true;
+#else
+        (void)samples;
+        return false;
+#endif
+    }
+    
+    void close() {
+#ifdef FACESECURE_HAVE_ALSA
+        if (device) {
+            snd_pcm_close(device);
+            device = nullptr;
+        }
+#endif
+    }
+
+private:
+#ifdef FACESECURE_HAVE_ALSA
+    snd_pcm_t* device = nullptr;
+#endif
+};
+
+// Retrieval-mode callback: append the synthesized samples to the vector
+// passed as user data to espeak_Synth
+int collectSamples(short* wav, int count, espeak_EVENT* events) {
+    if (wav && count > 0 && events) {
+        auto* samples = static_cast<std::vector<int16_t>*>(events->user_data);
+        samples->insert(samples->end(), wav, wav + count);
+    }
+    return 0;
+}
+
+} // namespace
+
+VoiceGreeter::VoiceGreeter(size_t queueCapacity, std::chrono::milliseconds maxDelay)
+    : speed(150), pitch(50), initialized(false), capacity(std::max<size_t>(1, queueCapacity)),
+      maxDelay(maxDelay), stopping(false), voiceChanged(false), caching(false), sampleRate(0) {}
+
+VoiceGreeter::~VoiceGreeter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+        renders.clear();
+    }
+    wake.notify_all();
+    if (audioThread.joinable()) {
+        audioThread.join();
+    }
+}
 
 bool VoiceGreeter::initialize() {
-    initialized = true;
-    return true;
+    if (initialized) return true;
+    
+    // espeak is not thread-safe, so it is loaded on the thread that speaks
+    std::promise<bool> ready;
+    std::future<bool> loaded = ready.get_future();
+    audioThread = std::thread(&VoiceGreeter::run, this, std::move(ready));
+    initialized = loaded.get();
+    if (!initialized) {
+        audioThread.join();
+    }
+    return initialized;
 }
 
 void VoiceGreeter::greet(const std::string& name) {
     if (!initialized) return;
     
-    std::string greeting = generateGreeting(name);
-    std::stringstream cmd;
-    cmd << "espeak -s " << speed << " -p " << pitch << " \"" << greeting << "\" &";
-    std::system(cmd.str().c_str());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        knownNames.insert(name);
+        
+        // Someone lingering in front of the camera is greeted once
+        bool waiting = std::any_of(queue.begin(), queue.end(),
+            [&name](const Pending& pending) { return pending.name == name; });
+        if (waiting || speaking == name) {
+            stats.merged++;
+            return;
+        }
+        
+        if (queue.size() >= capacity) {
+            queue.pop_front();
+            stats.dropped++;
+        }
+        queue.push_back({name, std::chrono::steady_clock::now()});
+    }
+    wake.notify_one();
+}
+
+void VoiceGreeter::prepare(const std::vector<std::string>& names) {
+    if (!initialized || !caching) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& name : names) {
+            if (knownNames.insert(name).second) {
+                renders.push_back(name);
+            }
+        }
+    }
+    wake.notify_one();
 }
 
 void VoiceGreeter::setVoiceSpeed(int speed) {
-    this->speed = speed;
+    if (this->speed.exchange(speed) != speed) {
+        changeVoice();
+    }
 }
 
 void VoiceGreeter::setVoicePitch(int pitch) {
-    this->pitch = pitch;
+    if (this->pitch.exchange(pitch) != pitch) {
+        changeVoice();
+    }
+}
+
+GreeterStats VoiceGreeter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void VoiceGreeter::changeVoice() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        voiceChanged = true;
+    }
+    wake.notify_one();
+}
+
+void VoiceGreeter::run(std::promise<bool> ready) {
+    // With an audio device of our own espeak only renders PCM (retrieval
+    // mode) and clips are played from the cache. Otherwise espeak plays
+    // synchronously, so espeak_Synth returns once the audio has played.
+    // Either way greetings are paced and never talk over each other.
+    PcmOutput output;
+    bool ownOutput = output.open();
+    sampleRate = espeak_Initialize(ownOutput ? AUDIO_OUTPUT_SYNCHRONOUS : AUDIO_OUTPUT_SYNCH_PLAYBACK, 0, nullptr, 0);
+    if (ownOutput && (sampleRate <= 0 || !output.configure(sampleRate))) {
+        output.close();
+        if (sampleRate > 0) {
+            espeak_Terminate();
+        }
+        ownOutput = false;
+        sampleRate = espeak_Initialize(AUDIO_OUTPUT_SYNCH_PLAYBACK, 0, nullptr, 0);
+    }
+    if (sampleRate <= 0) {
+        ready.set_value(false);
+        return;
+    }
+    if (ownOutput) {
+        espeak_SetSynthCallback(collectSamples);
+    }
+    caching = ownOutput;
+    ready.set_value(true);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !queue.empty() || !renders.empty() || voiceChanged; });
+        if (stopping) break;
+        
+        if (voiceChanged) {
+            voiceChanged = false;
+            if (ownOutput) {
+                renders.assign(knownNames.begin(), knownNames.end());
+                lock.unlock();
+                cache.invalidate(speed.load(), pitch.load());
+                lock.lock();
+            }
+            continue;
+        }
+        
+        if (queue.empty()) {
+            // Idle: render ahead so the greeting itself is only playback
+            std::string name = std::move(renders.front());
+            renders.pop_front();
+            lock.unlock();
+            bool cached = false;
+            clipFor(name, cached);
+            lock.lock();
+            continue;
+        }
+        
+        Pending next = std::move(queue.front());
+        queue.pop_front();
+        if (std::chrono::steady_clock::now() - next.queued > maxDelay) {
+            stats.dropped++;
+            continue;
+        }
+        speaking = next.name;
+        lock.unlock();
+        
+        bool spoken = false;
+        bool cached = false;
+        if (ownOutput) {
+            std::shared_ptr<const GreetingClip> clip = clipFor(next.name, cached);
+            spoken = clip && output.play(clip->samples);
+        } else {
+            std::string greeting = generateGreeting(next.name);
+            espeak_SetParameter(espeakRATE, speed.load(), 0);
+            espeak_SetParameter(espeakPITCH, pitch.load(), 0);
+            spoken = espeak_Synth(greeting.c_str(), greeting.size() + 1, 0, POS_CHARACTER, 0,
+                espeakCHARS_UTF8, nullptr, nullptr) == EE_OK;
+        }
+        
+        lock.lock();
+        speaking.clear();
+        if (spoken) {
+            stats.spoken++;
+            stats.cacheHits += cached ? 1 : 0;
+        } else {
+            stats.dropped++;
+        }
+    }
+    lock.unlock();
+    
+    espeak_Terminate();
+}
+
+std::shared_ptr<const GreetingClip> VoiceGreeter::render(const std::string& name) {
+    auto clip = std::make_shared<GreetingClip>();
+    clip->sampleRate = sampleRate;
+    clip->speed = speed.load();
+    clip->pitch = pitch.load();
+    
+    std::string greeting = generateGreeting(name);
+    espeak_SetParameter(espeakRATE, clip->speed, 0);
+    espeak_SetParameter(espeakPITCH, clip->pitch, 0);
+    if (espeak_Synth(greeting.c_str(), greeting.size() + 1, 0, POS_CHARACTER, 0, espeakCHARS_UTF8, nullptr,
+                     &clip->samples) != EE_OK || clip->samples.empty()) {
+        return nullptr;
+    }
+    return clip;
+}
+
+std::shared_ptr<const GreetingClip> VoiceGreeter::clipFor(const std::string& name, bool& cached) {
+    std::shared_ptr<const GreetingClip> clip = cache.find(name, speed.load(), pitch.load());
+    cached = clip != nullptr;
+    if (!clip) {
+        clip = render(name);
+        cache.store(name, clip);
+    }
+    return clip;
 }
 
 std::string VoiceGreeter::generateGreeting(const std::string& name) {
     return "Welcome, " + name;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,110 @@
+#include "../../include/gui/AttendanceTableModel.hpp"
+#include <algorithm>
+
+namespace {
+const int kFetchBatch = 256;
+}
+
+AttendanceTableModel::AttendanceTableModel(const AttendanceLogger& logger, QObject* parent)
+    : QAbstractTableModel(parent), logger(logger), filtered(false), totalRows(0), fetchedRows(0) {
+    showAll();
+}
+
+int AttendanceTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : fetchedRows;
+}
+
+int AttendanceTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : 3;
+}
+
+QVariant AttendanceTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || role != Qt::DisplayRole || index.row() >= fetchedRows) {
+        return QVariant();
+    }
+    
+    const AttendanceRecord& record = recordAt(index.row());
+    switch (index.column()) {
+    case 0: return QString::fromStdString(record.name);
+    case 1: return QString::fromStdString(record.date);
+    case 2: return QString::fromStdString(record.time);
+    default: return QVariant();
+    }
+}
+
+QVariant AttendanceTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    
+    switch (section) {
+    case 0: return QString("Name");
+    case 1: return QString("Date");
+    case 2: return QString("Time");
+    default: return QVariant();
+    }
+}
+
+bool AttendanceTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && fetchedRows < totalRows;
+}
+
+void AttendanceTableModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid()) return;
+    
+    int count = std::min(kFetchBatch, totalRows - fetchedRows);
+    if (count <= 0) return;
+    
+    beginInsertRows(QModelIndex(), fetchedRows, fetchedRows + count - 1);
+    fetchedRows += count;
+    endInsertRows();
+}
+
+void AttendanceTableModel::showAll() {
+    beginResetModel();
+    filtered = false;
+    positions.clear();
+    positions.shrink_to_fit();
+    totalRows = static_cast<int>(logger.allRecords().size());
+    fetchedRows = std::min(kFetchBatch, totalRows);
+    endResetModel();
+}
+
+void AttendanceTableModel::showView(const RecordView& view) {
+    beginResetModel();
+    filtered = true;
+    positions.clear();
+    positions.reserve(view.size());
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        positions.push_back(it.position());
+    }
+    totalRows = static_cast<int>(positions.size());
+    fetchedRows = std::min(kFetchBatch, totalRows);
+    endResetModel();
+}
+
+void AttendanceTableModel::recordsAppended() {
+    // A query result is a snapshot; it is refreshed by re-running the query
+    if (filtered) return;
+    
+    int newTotal = static_cast<int>(logger.allRecords().size());
+    if (newTotal <= totalRows) return;
+    
+    // Rows past an unfetched tail are picked up by fetchMore() later
+    bool fullyFetched = fetchedRows == totalRows;
+    totalRows = newTotal;
+    if (fullyFetched) {
+        beginInsertRows(QModelIndex(), fetchedRows, newTotal - 1);
+        fetchedRows = newTotal;
+        endInsertRows();
+    }
+}
+
+int AttendanceTableModel::matchCount() const {
+    return totalRows;
+}
+
+const AttendanceRecord& AttendanceTableModel::recordAt(int row) const {
+    const auto& records = logger.allRecords();
+    return filtered ? records[positions[row]] : records[row];
+}
@@ -0,0 +1,67 @@
+#include "../../include/gui/ImageConversion.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+namespace {
+
+// QImage cleanup hook: drops the reference that kept the pixels alive
+void releaseMat(void* mat) {
+    delete static_cast<cv::Mat*>(mat);
+}
+
+} // namespace
+
+QImage matToQImage(const cv::Mat& mat) {
+    if (mat.empty()) return QImage();
+    
+    if (mat.type() == CV_8UC3) {
+        cv::Mat rgb;
+        cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
+        return QImage((uchar*)rgb.data, rgb.cols, rgb.rows,
+            rgb.step, QImage::Format_RGB888).copy();
+    }
+    
+    return QImage((uchar*)mat.data, mat.cols, mat.rows,
+        mat.step, QImage::Format_Grayscale8).copy();
+}
+
+QImage wrapMat(const cv::Mat& mat) {
+    if (mat.empty()) return QImage();
+    
+    QImage::Format format;
+    cv::Mat* owner = nullptr;
+    if (mat.type() == CV_8UC3) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        format = QImage::Format_BGR888;
+        owner = new cv::Mat(mat);
+#else
+        format = QImage::Format_RGB888;
+        owner = new cv::Mat();
+        cv::cvtColor(mat, *owner, cv::COLOR_BGR2RGB);
+#endif
+    } else if (mat.type() == CV_8UC1) {
+        format = QImage::Format_Grayscale8;
+        owner = new cv::Mat(mat);
+    } else {
+        return QImage();
+    }
+    
+    // The const constructor keeps QImage from writing into the shared buffer
+    const uchar* pixels = owner->data;
+    return QImage(pixels, owner->cols, owner->rows, static_cast<int>(owner->step), format, releaseMat, owner);
+}
+
+QImage scaledFrameImage(const cv::Mat& frame, const QSize& size) {
+    if (frame.empty() || size.isEmpty()) return wrapMat(frame);
+    
+    double scale = std::min(static_cast<double>(size.width()) / frame.cols,
+                            static_cast<double>(size.height()) / frame.rows);
+    if (scale >= 1.0) {
+        return wrapMat(frame);
+    }
+    
+    cv::Size fitted(std::max(1, cvRound(frame.cols * scale)), std::max(1, cvRound(frame.rows * scale)));
+    cv::Mat scaled;
+    cv::resize(frame, scaled, fitted, 0, 0, cv::INTER_AREA);
+    return wrapMat(scaled);
+}
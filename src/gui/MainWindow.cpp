@@ -1,8 +1,11 @@
 #include "../../include/gui/MainWindow.hpp"
+#include "../../include/gui/ImageConversion.hpp"
+#include "../../include/core/MatPool.hpp"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QFile>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QSettings>
@@ -11,9 +14,32 @@
 #include <QDesktopWidget>
 #include <QScreen>
 #include <QFont>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+// Split a comma-separated list of camera sources
+std::vector<std::string> parseSources(const QString& text) {
+    std::vector<std::string> sources;
+    std::stringstream list(text.toStdString());
+    std::string source;
+    while (std::getline(list, source, ',')) {
+        size_t begin = source.find_first_not_of(" \t");
+        size_t end = source.find_last_not_of(" \t");
+        if (begin != std::string::npos) {
+            sources.push_back(source.substr(begin, end - begin + 1));
+        }
+    }
+    return sources;
+}
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent) 
     : QMainWindow(parent), 
+      streams(faceRecognizer),
+      enrollment(faceDetector),
       isCapturing(false), 
       recognitionCount(0),
       totalDetections(0) {
@@ -46,9 +72,14 @@ MainWindow::MainWindow(QWidget *parent)
     setupConnections();
     initializeComponents();
     loadSettings();
+    
+    // Render everyone's greeting in the loaded voice while the audio thread is idle
+    voiceGreeter.prepare(faceRecognizer.identityNames());
 }
 
 MainWindow::~MainWindow() {
+    // Callbacks of a running session would land on a half-destroyed window
+    enrollment.cancel();
     if (isCapturing) {
         stopRecognition();
     }
@@ -105,13 +136,11 @@ void MainWindow::setupRecognitionTab() {
     // Main content layout
     QHBoxLayout* contentLayout = new QHBoxLayout();
     
-    // Left side - Camera feed
+    // Left side - Camera feeds, one tile per stream
     QVBoxLayout* cameraLayout = new QVBoxLayout();
-    cameraFeed = new QLabel();
-    cameraFeed->setMinimumSize(640, 480);
-    cameraFeed->setAlignment(Qt::AlignCenter);
-    cameraFeed->setStyleSheet("background-color: #222; border: 1px solid #444; border-radius: 5px;");
-    cameraLayout->addWidget(cameraFeed);
+    cameraGrid = new QGridLayout();
+    cameraLayout->addLayout(cameraGrid);
+    setupCameraFeeds(1);
     
     // Start/Stop button
     startButton = new QPushButton("Start Recognition");
@@ -165,9 +194,6 @@ void MainWindow::setupRecognitionTab() {
 }
 
 void MainWindow::setupConnections() {
-    timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &MainWindow::updateFrame);
-    
     connect(startButton, &QPushButton::clicked, this, [this]() {
         if (!isCapturing) {
             startRecognition();
@@ -181,6 +207,10 @@ void MainWindow::setupConnections() {
         connect(registerButton, &QPushButton::clicked, this, &MainWindow::registerNewFace);
     }
     
+    if (removeButton) {
+        connect(removeButton, &QPushButton::clicked, this, &MainWindow::removePerson);
+    }
+    
     if (captureButton && captureProgress) {
         connect(captureButton, &QPushButton::clicked, this, [this]() {
             captureProgress->setValue(0);
@@ -200,6 +230,11 @@ void MainWindow::setupConnections() {
         connect(searchButton, &QPushButton::clicked, this, &MainWindow::searchAttendance);
     }
     
+    // Indexed search is cheap enough to run on every keystroke
+    if (searchBox) {
+        connect(searchBox, &QLineEdit::textChanged, this, &MainWindow::searchAttendance);
+    }
+    
     if (filterButton) {
         connect(filterButton, &QPushButton::clicked, this, &MainWindow::filterByDate);
     }
@@ -216,6 +251,33 @@ void MainWindow::setupConnections() {
     if (saveSettingsButton) {
         connect(saveSettingsButton, &QPushButton::clicked, this, &MainWindow::saveSettings);
     }
+    
+    // Check-ins are fsynced in batches; this covers the last one before a quiet spell
+    journalTimer = new QTimer(this);
+    connect(journalTimer, &QTimer::timeout, this, [this]() { attendanceLogger.flushIfDue(); });
+    journalTimer->start(250);
+}
+
+void MainWindow::setupCameraFeeds(size_t count) {
+    for (auto& view : streamViews) {
+        delete view->feed;
+    }
+    streamViews.clear();
+    
+    // Roughly square grid; a single camera keeps the full-size tile
+    int columns = 1;
+    while (static_cast<size_t>(columns * columns) < count) {
+        columns++;
+    }
+    QSize tileSize = count > 1 ? QSize(320, 240) : QSize(640, 480);
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto view = std::make_unique<StreamView>();
+        view->feed = new VideoWidget();
+        view->feed->setMinimumSize(tileSize.width(), tileSize.height());
+        cameraGrid->addWidget(view->feed, static_cast<int>(i) / columns, static_cast<int>(i) % columns);
+        streamViews.push_back(std::move(view));
+    }
 }
 
 void MainWindow::updateStats() {
@@ -223,36 +285,139 @@ void MainWindow::updateStats() {
     float successRate = totalDetections > 0 ? 
         static_cast<float>(recognitionCount) / totalDetections * 100.0f : 0.0f;
     
+    uint64_t recognizerRuns = 0;
+    uint64_t skippedDetections = 0;
+    FaceQualityStats quality;
+    uint64_t identityCommits = 0;
+    QString perStream;
+    for (size_t i = 0; i < streams.streamCount(); ++i) {
+        StreamStats stream = streams.stats(i);
+        recognizerRuns += stream.recognizerCalls;
+        skippedDetections += stream.skippedDetections;
+        quality.passed += stream.faceQuality.passed;
+        quality.tooSmall += stream.faceQuality.tooSmall;
+        quality.blurred += stream.faceQuality.blurred;
+        quality.exposure += stream.faceQuality.exposure;
+        quality.aspect += stream.faceQuality.aspect;
+        identityCommits += stream.identityCommits;
+        perStream += QString("\nCamera %1 (%2): %3")
+            .arg(static_cast<int>(i + 1))
+            .arg(QString::fromStdString(stream.source))
+            .arg(stream.running
+                ? QString("%1 frames, %2 dropped, detect %3 ms").arg(static_cast<qulonglong>(stream.frames))
+                      .arg(static_cast<qulonglong>(stream.droppedFrames))
+                      .arg(stream.detectMs, 0, 'f', 1)
+                : QString("stopped"));
+    }
+    
+    MatPoolStats buffers = MatPool::shared().stats();
+    GreeterStats greetings = voiceGreeter.getStats();
+    
     statsLabel->setText(
-        QString("Recognition started: %1\nRecognitions: %2\nTotal detections: %3\nSuccess rate: %4%")
+        QString("Recognition started: %1\nRecognitions: %2\nTotal detections: %3\nSuccess rate: %4%\nRecognizer runs: %5\nDetections skipped: %6\nFrame buffers: %7 allocated, %8 reused\nGreetings: %9 spoken (%10 pre-rendered), %11 merged, %12 dropped\nFaces rejected: %13 (%14 small, %15 blurred, %16 badly exposed, %17 cut off)\nIdentities confirmed: %18")
         .arg(status)
         .arg(recognitionCount)
         .arg(totalDetections)
         .arg(successRate, 0, 'f', 1)
+        .arg(static_cast<qulonglong>(recognizerRuns))
+        .arg(static_cast<qulonglong>(skippedDetections))
+        .arg(static_cast<qulonglong>(buffers.allocations))
+        .arg(static_cast<qulonglong>(buffers.reuses))
+        .arg(static_cast<qulonglong>(greetings.spoken))
+        .arg(static_cast<qulonglong>(greetings.cacheHits))
+        .arg(static_cast<qulonglong>(greetings.merged))
+        .arg(static_cast<qulonglong>(greetings.dropped))
+        .arg(static_cast<qulonglong>(quality.rejected()))
+        .arg(static_cast<qulonglong>(quality.tooSmall))
+        .arg(static_cast<qulonglong>(quality.blurred))
+        .arg(static_cast<qulonglong>(quality.exposure))
+        .arg(static_cast<qulonglong>(quality.aspect))
+        .arg(static_cast<qulonglong>(identityCommits))
+        + perStream
     );
 }
 
 void MainWindow::startRecognition() {
-    if (!capture.open(0)) {
+    // Registration holds the camera until its burst is over
+    if (enrollment.isRunning()) {
+        showMessage("Wait for registration capture to finish");
+        return;
+    }
+    
+    // The recognizer is only reconfigured while no stage is reading it;
+    // enabling the index builds it once if the snapshot had none
+    faceRecognizer.setApproximateSearch(approximateSearchCheckbox->isChecked());
+    
+    StreamOptions options;
+    options.sources = parseSources(cameraSourcesInput->text());
+    if (options.sources.empty()) {
+        options.sources = {"0"};
+    }
+    options.detector = faceDetector.getBackend();
+    options.minFaceSize = minFaceSizeSpin->value();
+    options.coarseToFine = coarseToFineCheckbox->isChecked();
+    options.pipeline.motionGate.enabled = motionGateCheckbox->isChecked();
+    options.pipeline.motionGate.changedFraction = MotionGate::fractionForSensitivity(motionSensitivitySlider->value());
+    options.pipeline.faceQuality.enabled = qualityGateCheckbox->isChecked();
+    options.pipeline.faceQuality.minSize = minRecognizeSizeSpin->value();
+    options.pipeline.voting.requiredShare = IdentityVoter::shareForThreshold(confidenceThresholdSlider->value());
+
+    // Tiles are only rebuilt while no stream can reference them
+    setupCameraFeeds(options.sources.size());
+
+    bool started = streams.start(options, [this](size_t stream, FrameResult&& result) {
+        // Runs on the stream's present thread: scale to the tile here and
+        // hand the GUI an image that shares the scaled buffer. Skip the
+        // image if the GUI has not shown the previous one yet, but always
+        // deliver the faces so no check-in is lost.
+        StreamView& view = *streamViews[stream];
+        QImage image;
+        if (!view.displayPending.exchange(true)) {
+            image = scaledFrameImage(result.frame, view.feed->targetSize());
+        }
+        QSize frameSize(result.frame.cols, result.frame.rows);
+        std::vector<FaceResult> faces = std::move(result.faces);
+        QMetaObject::invokeMethod(this, [this, stream, image, frameSize, faces]() {
+            updateFrame(stream, image, frameSize, faces);
+        }, Qt::QueuedConnection);
+    }, [this](size_t) {
+        // Files and network streams can end on their own; once the last one
+        // has, leave the running state as if Stop had been pressed
+        QMetaObject::invokeMethod(this, [this]() {
+            if (isCapturing && !streams.isRunning()) {
+                stopRecognition();
+                showMessage("All camera streams ended");
+            }
+        }, Qt::QueuedConnection);
+    });
+
+    if (!started) {
         QMessageBox::critical(this, "Error", "Failed to open camera. Please check your camera connection.");
         return;
     }
+    for (size_t i = 0; i < streams.streamCount(); ++i) {
+        StreamStats stream = streams.stats(i);
+        if (!stream.running) {
+            showMessage(QString("Failed to open camera %1").arg(QString::fromStdString(stream.source)));
+        }
+    }
     
     isCapturing = true;
     startButton->setText("Stop Recognition");
     startButton->setStyleSheet("background-color: #d9534f; color: white; font-weight: bold; border-radius: 5px;");
-    timer->start(30); // ~30 FPS
     updateStats();
     showMessage("Recognition started");
 }
 
 void MainWindow::stopRecognition() {
-    timer->stop();
-    capture.release();
+    streams.stop();
+    for (auto& view : streamViews) {
+        view->displayPending = false;
+        view->feed->clear();
+    }
     isCapturing = false;
     startButton->setText("Start Recognition");
     startButton->setStyleSheet("background-color: #2a82da; color: white; font-weight: bold; border-radius: 5px;");
-    cameraFeed->clear();
     currentPersonLabel->setText("No face detected");
     confidenceBar->setValue(0);
     updateStats();
@@ -299,7 +464,7 @@ void MainWindow::setupRegistrationTab() {
     captureProgress = new QProgressBar();
     captureProgress->setRange(0, 5);
     captureProgress->setValue(0);
-    captureProgress->setFormat("Capture progress: %v/5");
+    captureProgress->setFormat("Capture progress: %v/%m");
     captureProgress->setStyleSheet("QProgressBar { border: 1px solid #444; border-radius: 5px; text-align: center; } QProgressBar::chunk { background-color: #2a82da; }");
     layout->addWidget(captureProgress);
     
@@ -309,6 +474,12 @@ void MainWindow::setupRegistrationTab() {
     registerButton->setStyleSheet("background-color: #28a745; color: white; font-weight: bold; border-radius: 5px;");
     layout->addWidget(registerButton);
     
+    // Remove button
+    removeButton = new QPushButton("Remove Person");
+    removeButton->setMinimumHeight(40);
+    removeButton->setStyleSheet("background-color: #dc3545; color: white; font-weight: bold; border-radius: 5px;");
+    layout->addWidget(removeButton);
+    
     // Add some spacing
     layout->addStretch();
     
@@ -334,7 +505,7 @@ void MainWindow::setupAttendanceTab() {
     
     // Search controls
     searchBox = new QLineEdit();
-    searchBox->setPlaceholderText("Search by name");
+    searchBox->setPlaceholderText("Search by name or surname");
     searchButton = new QPushButton("Search");
     searchButton->setStyleSheet("background-color: #2a82da; color: white; font-weight: bold; border-radius: 5px;");
     
@@ -355,12 +526,16 @@ void MainWindow::setupAttendanceTab() {
     layout->addLayout(controlsLayout);
     
     // Attendance table
-    attendanceTable = new QTableWidget();
-    attendanceTable->setColumnCount(3);
-    attendanceTable->setHorizontalHeaderLabels({"Name", "Date", "Time"});
+    attendanceModel = new AttendanceTableModel(attendanceLogger, this);
+    attendanceTable = new QTableView();
+    attendanceTable->setModel(attendanceModel);
     attendanceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Fixed row heights keep scrolling independent of the number of records
+    attendanceTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    attendanceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    attendanceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     attendanceTable->setAlternatingRowColors(true);
-    attendanceTable->setStyleSheet("QTableWidget { border: 1px solid #444; border-radius: 5px; alternate-background-color: #333; }");
+    attendanceTable->setStyleSheet("QTableView { border: 1px solid #444; border-radius: 5px; alternate-background-color: #333; }");
     
     layout->addWidget(attendanceTable, 1);
     
@@ -428,9 +603,13 @@ void MainWindow::setupSettingsTab() {
     
     QLabel* typeLabel = new QLabel("Recognizer Type:");
     recognizerTypeCombo = new QComboBox();
-    recognizerTypeCombo->addItems({"LBPH", "Eigenfaces", "Fisherfaces"});
+    // Items follow RecognizerType, whose order the stored index relies on
+    recognizerTypeCombo->addItem("LBPH", "lbph");
+    recognizerTypeCombo->addItem("Eigenfaces", "eigenfaces");
+    recognizerTypeCombo->addItem("Fisherfaces", "fisherfaces");
+    recognizerTypeCombo->addItem("SFace (DNN)", "sface");
     
-    QLabel* thresholdLabel = new QLabel("Confidence Threshold:");
+    QLabel* thresholdLabel = new QLabel("Confidence Threshold (agreement needed before attendance is logged):");
     confidenceThresholdSlider = new QSlider(Qt::Horizontal);
     confidenceThresholdSlider->setRange(0, 100);
     confidenceThresholdSlider->setValue(70);
@@ -440,15 +619,82 @@ void MainWindow::setupSettingsTab() {
     autoSaveCheckbox = new QCheckBox("Auto-save attendance logs");
     autoSaveCheckbox->setChecked(true);
     
+    approximateSearchCheckbox = new QCheckBox("Approximate search (large galleries)");
+    approximateSearchCheckbox->setChecked(false);
+    
     recognitionLayout->addWidget(typeLabel);
     recognitionLayout->addWidget(recognizerTypeCombo);
     recognitionLayout->addWidget(thresholdLabel);
     recognitionLayout->addWidget(confidenceThresholdSlider);
     recognitionLayout->addWidget(autoSaveCheckbox);
+    recognitionLayout->addWidget(approximateSearchCheckbox);
+    
+    // Detection settings
+    QGroupBox* detectionGroup = new QGroupBox("Detection Settings");
+    QVBoxLayout* detectionLayout = new QVBoxLayout(detectionGroup);
+    
+    QLabel* detectorLabel = new QLabel("Face Detector:");
+    detectorTypeCombo = new QComboBox();
+    detectorTypeCombo->addItem("Haar cascade", "haar");
+    detectorTypeCombo->addItem("LBP cascade (fastest)", "lbp");
+    detectorTypeCombo->addItem("YuNet DNN (fewest false detections)", "yunet");
+    detectorTypeCombo->addItem("ResNet SSD DNN", "ssd");
+    
+    detectionLayout->addWidget(detectorLabel);
+    detectionLayout->addWidget(detectorTypeCombo);
+    
+    QLabel* minFaceLabel = new QLabel("Minimum Face Size:");
+    minFaceSizeSpin = new QSpinBox();
+    minFaceSizeSpin->setRange(20, 400);
+    minFaceSizeSpin->setValue(30);
+    minFaceSizeSpin->setSuffix(" px");
+    
+    coarseToFineCheckbox = new QCheckBox("Coarse-to-fine detection (faster on HD cameras)");
+    coarseToFineCheckbox->setChecked(false);
+    
+    detectionLayout->addWidget(minFaceLabel);
+    detectionLayout->addWidget(minFaceSizeSpin);
+    detectionLayout->addWidget(coarseToFineCheckbox);
+    
+    motionGateCheckbox = new QCheckBox("Skip detection when the scene is static");
+    motionGateCheckbox->setChecked(true);
+    
+    QLabel* motionLabel = new QLabel("Motion Sensitivity:");
+    motionSensitivitySlider = new QSlider(Qt::Horizontal);
+    motionSensitivitySlider->setRange(1, 100);
+    motionSensitivitySlider->setValue(50);
+    motionSensitivitySlider->setTickPosition(QSlider::TicksBelow);
+    motionSensitivitySlider->setTickInterval(10);
+    
+    detectionLayout->addWidget(motionGateCheckbox);
+    detectionLayout->addWidget(motionLabel);
+    detectionLayout->addWidget(motionSensitivitySlider);
+    
+    qualityGateCheckbox = new QCheckBox("Only recognize sharp, well-lit, fully visible faces");
+    qualityGateCheckbox->setChecked(true);
+    
+    QLabel* minRecognizeLabel = new QLabel("Minimum Face Size for Recognition:");
+    minRecognizeSizeSpin = new QSpinBox();
+    minRecognizeSizeSpin->setRange(20, 400);
+    minRecognizeSizeSpin->setValue(40);
+    minRecognizeSizeSpin->setSuffix(" px");
+    
+    detectionLayout->addWidget(qualityGateCheckbox);
+    detectionLayout->addWidget(minRecognizeLabel);
+    detectionLayout->addWidget(minRecognizeSizeSpin);
+    
+    QLabel* sourcesLabel = new QLabel("Camera Sources (comma-separated device numbers, files or URLs):");
+    cameraSourcesInput = new QLineEdit();
+    cameraSourcesInput->setPlaceholderText("0");
+    cameraSourcesInput->setText("0");
+    
+    detectionLayout->addWidget(sourcesLabel);
+    detectionLayout->addWidget(cameraSourcesInput);
     
     // Add groups to main layout
     layout->addWidget(voiceGroup);
     layout->addWidget(recognitionGroup);
+    layout->addWidget(detectionGroup);
     
     // Save settings button
     saveSettingsButton = new QPushButton("Save Settings");
@@ -483,9 +729,33 @@ void MainWindow::initializeComponents() {
         QMessageBox::warning(this, "Initialization Warning", "Failed to initialize voice system. Voice greetings may not work.");
     }
     
-    // Try to load existing model
-    if (faceRecognizer.loadModel()) {
+    // A model from before the binary gallery format is converted once, so
+    // later starts can map it. This has to be decided on the files: with
+    // a journal, loading succeeds even without a snapshot.
+    QString gallery = RecognizerBackend::defaultGalleryFile(RecognizerType::Lbph);
+    if (!QFile::exists(gallery) && QFile::exists("data/trained_model.yml")) {
+        if (FaceRecognizer::convertModel("data/trained_model.yml", gallery.toStdString())) {
+            showMessage("Converted recognition model to the binary gallery format");
+        } else {
+            QMessageBox::warning(this, "Model Conversion Failed",
+                "data/trained_model.yml could not be converted to " + gallery + ".\n"
+                "People enrolled in it are not recognized until it is converted.");
+        }
+    }
+    
+    // The saved index is only read with approximate search on, and the
+    // settings are applied after this
+    QSettings settings("FaceSecure", "FaceSecure++");
+    faceRecognizer.setApproximateSearch(settings.value("recognition/approximate", false).toBool());
+    
+    bool modelLoaded = faceRecognizer.loadModel();
+    if (modelLoaded) {
         showMessage("Recognition model loaded successfully");
+        
+        // Fold a long enrollment journal back into the snapshot
+        if (faceRecognizer.pendingJournalRecords() > 64) {
+            faceRecognizer.saveModel();
+        }
     }
     
     updateAttendanceTable();
@@ -493,6 +763,11 @@ void MainWindow::initializeComponents() {
 }
 
 void MainWindow::registerNewFace() {
+    if (enrollment.isRunning()) {
+        showMessage("Registration capture is already running");
+        return;
+    }
+    
     if (nameInput->text().isEmpty()) {
         QMessageBox::warning(this, "Input Error", "Please enter a name for the person to register.");
         mainTabWidget->setCurrentWidget(registrationTab);
@@ -502,47 +777,75 @@ void MainWindow::registerNewFace() {
     
     QString name = nameInput->text();
     
-    if (!capture.isOpened()) {
-        if (!capture.open(0)) {
-            QMessageBox::critical(this, "Camera Error", "Failed to open camera. Please check your camera connection.");
-            return;
-        }
+    // Streams share the recognizer, and possibly the camera, with registration
+    if (isCapturing) {
+        stopRecognition();
     }
     
-    std::vector<cv::Mat> faceImages;
-    int imagesNeeded = 5;
-    captureProgress->setMaximum(imagesNeeded);
+    // Register from the first configured camera
+    EnrollmentConfig config;
+    std::vector<std::string> sources = parseSources(cameraSourcesInput->text());
+    if (!sources.empty()) {
+        config.source = sources.front();
+    }
+    
+    captureProgress->setMaximum(config.samples);
     captureProgress->setValue(0);
     
-    while (imagesNeeded > 0) {
-        cv::Mat frame;
-        capture >> frame;
-        if (frame.empty()) continue;
-        
-        auto faces = faceDetector.detectFaces(frame);
-        
-        // Show preview
-        QImage previewImg = matToQImage(faceDetector.getAnnotatedFrame());
-        previewLabel->setPixmap(QPixmap::fromImage(previewImg).scaled(previewLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        
-        if (faces.size() == 1) {
-            cv::Mat faceROI = frame(faces[0]);
-            faceImages.push_back(faceROI.clone());
-            imagesNeeded--;
-            captureProgress->setValue(5 - imagesNeeded);
-            showMessage("Captured face " + QString::number(5 - imagesNeeded) + "/5");
-            QThread::msleep(500);
-        }
-        
-        QApplication::processEvents();
+    // Scale previews on the session thread, to the label size at start
+    QSize previewSize = previewLabel->size();
+    enrollmentPreviewPending = false;
+    
+    bool started = enrollment.start(config,
+        [this, previewSize](EnrollmentProgress&& progress) {
+            int usable = std::min(progress.candidates, progress.needed);
+            QImage image;
+            if (!enrollmentPreviewPending.exchange(true)) {
+                image = scaledFrameImage(progress.preview, previewSize);
+            }
+            QMetaObject::invokeMethod(this, [this, image, usable]() {
+                if (!image.isNull()) {
+                    previewLabel->setPixmap(QPixmap::fromImage(image));
+                    enrollmentPreviewPending = false;
+                }
+                captureProgress->setValue(usable);
+            }, Qt::QueuedConnection);
+        },
+        [this, name](EnrollmentResult&& result) {
+            QMetaObject::invokeMethod(this, [this, name, result]() {
+                finishEnrollment(name, result);
+            }, Qt::QueuedConnection);
+        });
+    
+    if (!started) {
+        QMessageBox::critical(this, "Camera Error", "Failed to open camera. Please check your camera connection.");
+        return;
     }
     
-    if (!isCapturing) {
-        capture.release();
+    captureButton->setEnabled(false);
+    registerButton->setEnabled(false);
+    removeButton->setEnabled(false);
+    showMessage("Capturing " + name + ": look at the camera and turn your head slightly");
+}
+
+void MainWindow::finishEnrollment(const QString& name, const EnrollmentResult& result) {
+    captureButton->setEnabled(true);
+    registerButton->setEnabled(true);
+    removeButton->setEnabled(true);
+    
+    if (!result.success) {
+        QMessageBox::critical(this, "Registration Failed", 
+                             "Failed to register " + name + ".\n" + QString::fromStdString(result.error) +
+                             ". Please face the camera in good light and try again.");
+        return;
     }
     
-    if (faceRecognizer.train(name.toStdString(), faceImages)) {
-        faceRecognizer.saveModel();
+    showMessage(QString("Selected %1 face images for %2 (best quality %3)")
+        .arg(result.faces.size()).arg(name).arg(result.qualities.front(), 0, 'f', 2));
+    
+    // Enrollment appends to the gallery journal; no full model rewrite
+    if (faceRecognizer.enroll(name.toStdString(), result.faces)) {
+        voiceGreeter.prepare({name.toStdString()});
         QMessageBox::information(this, "Registration Successful", 
                                 "Successfully registered " + name + ".\nThe system can now recognize this person.");
         nameInput->clear();
@@ -554,37 +857,62 @@ void MainWindow::registerNewFace() {
     }
 }
 
-void MainWindow::updateFrame() {
-    cv::Mat frame;
-    capture >> frame;
-    if (frame.empty()) return;
+void MainWindow::removePerson() {
+    if (nameInput->text().isEmpty()) {
+        QMessageBox::warning(this, "Input Error", "Please enter the name of the person to remove.");
+        mainTabWidget->setCurrentWidget(registrationTab);
+        nameInput->setFocus();
+        return;
+    }
+    
+    QString name = nameInput->text();
+    std::vector<std::string> names = faceRecognizer.identityNames();
+    if (std::find(names.begin(), names.end(), name.toStdString()) == names.end()) {
+        QMessageBox::warning(this, "Not Registered", name + " is not registered.");
+        return;
+    }
+    
+    if (QMessageBox::question(this, "Confirm Removal",
+        "Remove every face image of " + name + "?\nThis person will no longer be recognized.",
+        QMessageBox::Yes | QMessageBox::No) != QMessageBox::Yes) {
+        return;
+    }
+    
+    // Streams match against the gallery that is about to change
+    if (isCapturing) {
+        stopRecognition();
+    }
+    
+    // The removal is journaled before the gallery changes
+    if (faceRecognizer.remove(name.toStdString())) {
+        showMessage("Removed " + name + " from the gallery");
+        nameInput->clear();
+    } else {
+        QMessageBox::critical(this, "Removal Failed",
+                             "The removal of " + name + " could not be saved, so " + name +
+                             " is still registered. Please try again.");
+    }
+}
+
+void MainWindow::updateFrame(size_t stream, const QImage& image, const QSize& frameSize, const std::vector<FaceResult>& faces) {
+    if (!isCapturing || stream >= streamViews.size()) return;
     
-    auto faces = faceDetector.detectFaces(frame);
     totalDetections += faces.size();
     
     for (const auto& face : faces) {
-        cv::Mat faceROI = frame(face);
-        double confidence;
-        std::string name = faceRecognizer.recognize(faceROI, confidence);
-        
-        if (name != "Unknown") {
-            confidenceBar->setValue(static_cast<int>(100.0 - confidence));
-            currentPersonLabel->setText(QString::fromStdString(name));
-            
-            cv::putText(frame, name, cv::Point(face.x, face.y - 10),
-                cv::FONT_HERSHEY_SIMPLEX, 0.9, cv::Scalar(0, 255, 0), 2);
+        if (face.name != "Unknown") {
+            confidenceBar->setValue(static_cast<int>(100.0 - face.confidence));
+            currentPersonLabel->setText(QString::fromStdString(face.name));
             
-            if (attendanceLogger.logAttendance(name)) {
-                voiceGreeter.greet(name);
-                updateAttendanceTable();
+            // Only identities the stream's voting has settled on are logged
+            if (face.committed && attendanceLogger.logAttendance(face.name)) {
+                voiceGreeter.greet(face.name);
+                attendanceModel->recordsAppended();
                 recognitionCount++;
             }
         } else {
             confidenceBar->setValue(0);
             currentPersonLabel->setText("Unknown Person");
-            
-            cv::putText(frame, "Unknown", cv::Point(face.x, face.y - 10),
-                cv::FONT_HERSHEY_SIMPLEX, 0.9, cv::Scalar(0, 0, 255), 2);
         }
     }
     
@@ -593,7 +921,10 @@ void MainWindow::updateFrame() {
         currentPersonLabel->setText("No face detected");
     }
     
-    cameraFeed->setPixmap(QPixmap::fromImage(matToQImage(frame)).scaled(cameraFeed->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    if (!image.isNull()) {
+        streamViews[stream]->feed->setFrame(image, frameSize, faces);
+        streamViews[stream]->displayPending = false;
+    }
     updateStats();
 }
 
@@ -604,21 +935,10 @@ void MainWindow::searchAttendance() {
         return;
     }
     
-    auto records = attendanceLogger.getRecords();
-    attendanceTable->setRowCount(0);
-    
-    int row = 0;
-    for (size_t i = 0; i < records.size(); ++i) {
-        QString name = QString::fromStdString(records[i].name);
-        if (name.contains(searchTerm, Qt::CaseInsensitive)) {
-            attendanceTable->insertRow(row);
-            attendanceTable->setItem(row, 0, new QTableWidgetItem(name));
-            attendanceTable->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(records[i].date)));
-            attendanceTable->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(records[i].time)));
-            row++;
-        }
-    }
+    RecordView records = attendanceLogger.recordsMatching(searchTerm.toStdString());
+    showRecords(records);
     
+    int row = attendanceModel->matchCount();
     if (row == 0) {
         showMessage("No matching records found");
     } else {
@@ -630,21 +950,10 @@ void MainWindow::filterByDate() {
     QDate selectedDate = dateFilter->date();
     QString dateStr = selectedDate.toString("yyyy-MM-dd");
     
-    auto records = attendanceLogger.getRecords();
-    attendanceTable->setRowCount(0);
-    
-    int row = 0;
-    for (size_t i = 0; i < records.size(); ++i) {
-        QString recordDate = QString::fromStdString(records[i].date);
-        if (recordDate == dateStr) {
-            attendanceTable->insertRow(row);
-            attendanceTable->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(records[i].name)));
-            attendanceTable->setItem(row, 1, new QTableWidgetItem(recordDate));
-            attendanceTable->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(records[i].time)));
-            row++;
-        }
-    }
+    RecordView records = attendanceLogger.recordsOn(dateStr.toStdString());
+    showRecords(records);
     
+    int row = attendanceModel->matchCount();
     if (row == 0) {
         showMessage(QString("No attendance records found for %1").arg(dateStr));
     } else {
@@ -652,6 +961,10 @@ void MainWindow::filterByDate() {
     }
 }
 
+void MainWindow::showRecords(const RecordView& records) {
+    attendanceModel->showView(records);
+}
+
 void MainWindow::saveSettings() {
     QSettings settings("FaceSecure", "FaceSecure++");
     
@@ -663,6 +976,21 @@ void MainWindow::saveSettings() {
     settings.setValue("recognition/type", recognizerTypeCombo->currentIndex());
     settings.setValue("recognition/threshold", confidenceThresholdSlider->value());
     settings.setValue("recognition/autoSave", autoSaveCheckbox->isChecked());
+    settings.setValue("recognition/approximate", approximateSearchCheckbox->isChecked());
+    
+    // Detection settings
+    settings.setValue("detection/backend", detectorTypeCombo->currentData());
+    settings.setValue("detection/minFaceSize", minFaceSizeSpin->value());
+    settings.setValue("detection/coarseToFine", coarseToFineCheckbox->isChecked());
+    settings.setValue("detection/motionGate", motionGateCheckbox->isChecked());
+    settings.setValue("detection/motionSensitivity", motionSensitivitySlider->value());
+    settings.setValue("detection/qualityGate", qualityGateCheckbox->isChecked());
+    settings.setValue("detection/minRecognizeSize", minRecognizeSizeSpin->value());
+    settings.setValue("detection/sources", cameraSourcesInput->text());
+    
+    // Apply recognition and detection settings
+    changeRecognitionSettings();
+    applyDetectorSettings();
     
     // Apply voice settings
     voiceGreeter.setVoiceSpeed(voiceSpeedSlider->value());
@@ -682,12 +1010,48 @@ void MainWindow::loadSettings() {
     recognizerTypeCombo->setCurrentIndex(settings.value("recognition/type", 0).toInt());
     confidenceThresholdSlider->setValue(settings.value("recognition/threshold", 70).toInt());
     autoSaveCheckbox->setChecked(settings.value("recognition/autoSave", true).toBool());
+    approximateSearchCheckbox->setChecked(settings.value("recognition/approximate", false).toBool());
+    
+    // Detection settings
+    int detectorIndex = detectorTypeCombo->findData(settings.value("detection/backend", "haar"));
+    detectorTypeCombo->setCurrentIndex(detectorIndex >= 0 ? detectorIndex : 0);
+    minFaceSizeSpin->setValue(settings.value("detection/minFaceSize", 30).toInt());
+    coarseToFineCheckbox->setChecked(settings.value("detection/coarseToFine", false).toBool());
+    motionGateCheckbox->setChecked(settings.value("detection/motionGate", true).toBool());
+    motionSensitivitySlider->setValue(settings.value("detection/motionSensitivity", 50).toInt());
+    qualityGateCheckbox->setChecked(settings.value("detection/qualityGate", true).toBool());
+    minRecognizeSizeSpin->setValue(settings.value("detection/minRecognizeSize", 40).toInt());
+    cameraSourcesInput->setText(settings.value("detection/sources", "0").toString());
+    changeRecognitionSettings();
+    applyDetectorSettings();
     
     // Apply voice settings
     voiceGreeter.setVoiceSpeed(voiceSpeedSlider->value());
     voiceGreeter.setVoicePitch(voicePitchSlider->value());
 }
 
+void MainWindow::applyDetectorSettings() {
+    // Running streams keep the backend they started with; a new one is
+    // picked up by the next start
+    DetectorType type = DetectorType::HaarCascade;
+    DetectorBackend::parseType(detectorTypeCombo->currentData().toString().toStdString(), type);
+    
+    std::shared_ptr<DetectorBackend> current = faceDetector.getBackend();
+    if (!current || current->type() != type) {
+        if (!faceDetector.initialize(type)) {
+            showMessage(QString("Could not load the model for %1 (%2); keeping the current detector")
+                .arg(detectorTypeCombo->currentText())
+                .arg(DetectorBackend::defaultModelFile(type)));
+            current = faceDetector.getBackend();
+            int index = current ? detectorTypeCombo->findData(DetectorBackend::typeName(current->type())) : 0;
+            detectorTypeCombo->setCurrentIndex(std::max(0, index));
+        }
+    }
+    
+    faceDetector.setMinFaceSize(minFaceSizeSpin->value());
+    faceDetector.setCoarseToFine(coarseToFineCheckbox->isChecked());
+}
+
 void MainWindow::playGreeting(const std::string& name) {
     voiceGreeter.greet(name);
 }
@@ -732,36 +1096,15 @@ void MainWindow::clearLog() {
 }
 
 void MainWindow::updateAttendanceTable() {
-    if (!attendanceTable) return;
+    if (!attendanceModel) return;
     
-    auto records = attendanceLogger.getRecords();
-    attendanceTable->setRowCount(records.size());
-    
-    for (size_t i = 0; i < records.size(); ++i) {
-        attendanceTable->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(records[i].name)));
-        attendanceTable->setItem(i, 1, new QTableWidgetItem(QString::fromStdString(records[i].date)));
-        attendanceTable->setItem(i, 2, new QTableWidgetItem(QString::fromStdString(records[i].time)));
-    }
+    attendanceModel->showAll();
 }
 
 void MainWindow::showMessage(const QString& message) {
     statusBar->showMessage(message, 3000);
 }
 
-QImage MainWindow::matToQImage(const cv::Mat& mat) {
-    if (mat.empty()) return QImage();
-    
-    if (mat.type() == CV_8UC3) {
-        cv::Mat rgb;
-        cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-        return QImage((uchar*)rgb.data, rgb.cols, rgb.rows,
-            rgb.step, QImage::Format_RGB888).copy();
-    }
-    
-    return QImage((uchar*)mat.data, mat.cols, mat.rows,
-        mat.step, QImage::Format_Grayscale8).copy();
-}
-
 void MainWindow::adjustVoiceSettings() {
     voiceGreeter.setVoiceSpeed(voiceSpeedSlider->value());
     voiceGreeter.setVoicePitch(voicePitchSlider->value());
@@ -771,12 +1114,30 @@ void MainWindow::adjustVoiceSettings() {
 }
 
 void MainWindow::changeRecognitionSettings() {
-    // This would update recognition parameters based on UI settings
-    int threshold = confidenceThresholdSlider->value();
-    int recognizerType = recognizerTypeCombo->currentIndex();
-    
-    // In a real implementation, this would modify the face recognizer settings
-    showMessage(QString("Recognition settings updated: Type=%1, Threshold=%2")
-                .arg(recognizerTypeCombo->currentText())
-                .arg(threshold));
+    RecognizerType type = RecognizerType::Lbph;
+    RecognizerBackend::parseType(recognizerTypeCombo->currentData().toString().toStdString(), type);
+    if (faceRecognizer.getType() == type) {
+        return;
+    }
+    
+    // Every backend has its own gallery, so streams matching against the
+    // old one are stopped first. Enrollments stay in the old backend's
+    // journal and snapshot for when it is selected again.
+    if (isCapturing) {
+        stopRecognition();
+    }
+    
+    if (!faceRecognizer.initialize(type)) {
+        showMessage(QString("Could not load the model for %1 (%2); keeping the current recognizer")
+            .arg(recognizerTypeCombo->currentText())
+            .arg(RecognizerBackend::defaultModelFile(type)));
+        recognizerTypeCombo->setCurrentIndex(static_cast<int>(faceRecognizer.getType()));
+        return;
+    }
+    
+    faceRecognizer.loadModel();
+    voiceGreeter.prepare(faceRecognizer.identityNames());
+    showMessage(QString("Recognizer switched to %1: %2 people enrolled")
+        .arg(recognizerTypeCombo->currentText())
+        .arg(static_cast<qulonglong>(faceRecognizer.identityCount())));
 } 
\ No newline at end of file
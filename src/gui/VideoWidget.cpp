@@ -0,0 +1,66 @@
+#include "../../include/gui/VideoWidget.hpp"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+VideoWidget::VideoWidget(QWidget* parent)
+    : QWidget(parent), targetWidth(640), targetHeight(480) {}
+
+void VideoWidget::setFrame(const QImage& frame, const QSize& originalSize, const std::vector<FaceResult>& results) {
+    image = frame;
+    frameSize = originalSize;
+    faces = results;
+    update();
+}
+
+void VideoWidget::clear() {
+    image = QImage();
+    faces.clear();
+    update();
+}
+
+QSize VideoWidget::targetSize() const {
+    return QSize(targetWidth.load(), targetHeight.load());
+}
+
+void VideoWidget::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(34, 34, 34));
+    if (image.isNull() || frameSize.isEmpty()) {
+        return;
+    }
+
+    // Fit the frame into the widget; only a resize since the frame was
+    // scaled makes the painter rescale it
+    QSize fitted = frameSize.scaled(size(), Qt::KeepAspectRatio);
+    QRect target(QPoint((width() - fitted.width()) / 2, (height() - fitted.height()) / 2), fitted);
+    if (image.size() != fitted) {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    }
+    painter.drawImage(target, image);
+
+    double scale = static_cast<double>(fitted.width()) / frameSize.width();
+    QFont font = painter.font();
+    font.setPointSize(12);
+    font.setBold(true);
+    painter.setFont(font);
+
+    for (const auto& face : faces) {
+        QRect box(target.x() + static_cast<int>(face.box.x * scale),
+                  target.y() + static_cast<int>(face.box.y * scale),
+                  static_cast<int>(face.box.width * scale),
+                  static_cast<int>(face.box.height * scale));
+        bool known = face.name != "Unknown";
+
+        painter.setPen(QPen(QColor(0, 255, 0), 2));
+        painter.drawRect(box);
+        painter.setPen(known ? QColor(0, 255, 0) : QColor(255, 0, 0));
+        painter.drawText(QPoint(box.x(), box.y() - 6), QString::fromStdString(face.name));
+    }
+}
+
+void VideoWidget::resizeEvent(QResizeEvent* event) {
+    targetWidth = event->size().width();
+    targetHeight = event->size().height();
+    QWidget::resizeEvent(event);
+}
@@ -1,9 +1,202 @@
 #include "../include/gui/MainWindow.hpp"
+#include "../include/core/BatchProcessor.hpp"
 #include <QApplication>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void printBatchUsage() {
+    std::fprintf(stderr,
+        "Usage: FaceSecure++ --batch [options] <video|image-dir>...\n"
+        "  --threads N     worker threads (default: all cores)\n"
+        "  --stride N      process every Nth video frame (default: 1)\n"
+        "  --min-face N    smallest face in pixels; enables coarse-to-fine detection\n"
+        "  --ann EF        approximate gallery search with the given efSearch\n"
+        "  --recognizer NAME\n"
+        "                  face recognizer: lbph, eigenfaces, fisherfaces or sface\n"
+        "                  (default: lbph)\n"
+        "  --recognizer-model FILE\n"
+        "                  network for sface (default: the bundled file under data/)\n"
+        "  --model FILE    recognition model (default: the recognizer's gallery under\n"
+        "                  data/, e.g. data/trained_model.gallery for lbph)\n"
+        "  --detector NAME face detector: haar, lbp, yunet or ssd (default: haar)\n"
+        "  --detector-model FILE\n"
+        "                  detector model (default: the bundled file under data/)\n"
+        "  --detector-config FILE\n"
+        "                  network definition for ssd (default: data/deploy.prototxt)\n"
+        "  --cascade FILE  same as --detector-model, kept for existing scripts\n"
+        "\n"
+        "       FaceSecure++ --convert-model <input> <output>\n"
+        "  Rewrite a recognition model; an output ending in .gallery is written in\n"
+        "  the binary gallery format, anything else as OpenCV YAML.\n");
+}
+
+// Parse a whole argument as an integer in [minimum, INT_MAX]
+static bool parseNumber(const char *text, int minimum, int& value) {
+    char *end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < minimum || parsed > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Quote a CSV field when it holds a separator, quote or line break
+static std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// Convert a model between YAML and the binary gallery format
+static int runConvert(const std::string& input, const std::string& output) {
+    if (!FaceRecognizer::convertModel(input, output)) {
+        std::fprintf(stderr, "Failed to convert %s to %s\n", input.c_str(), output.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "Wrote %s\n", output.c_str());
+    return 0;
+}
+
+// Headless mode: attendance events as CSV on stdout, throughput on stderr
+static int runBatch(int argc, char *argv[]) {
+    BatchOptions options;
+    std::string modelFile;
+    RecognizerType recognizerType = RecognizerType::Lbph;
+    std::string recognizerModel;
+    int efSearch = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--batch") {
+            continue;
+        } else if (arg == "--threads" && hasValue) {
+            int threads = 0;
+            if (!parseNumber(argv[++i], 0, threads)) {
+                printBatchUsage();
+                return 2;
+            }
+            options.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--stride" && hasValue) {
+            if (!parseNumber(argv[++i], 1, options.frameStride)) {
+                printBatchUsage();
+                return 2;
+            }
+        } else if (arg == "--ann" && hasValue) {
+            if (!parseNumber(argv[++i], 1, efSearch)) {
+                printBatchUsage();
+                return 2;
+            }
+        } else if (arg == "--min-face" && hasValue) {
+            if (!parseNumber(argv[++i], 0, options.minFaceSize)) {
+                printBatchUsage();
+                return 2;
+            }
+        } else if (arg == "--model" && hasValue) {
+            modelFile = argv[++i];
+        } else if (arg == "--recognizer" && hasValue) {
+            if (!RecognizerBackend::parseType(argv[++i], recognizerType)) {
+                printBatchUsage();
+                return 2;
+            }
+        } else if (arg == "--recognizer-model" && hasValue) {
+            recognizerModel = argv[++i];
+        } else if (arg == "--detector" && hasValue) {
+            if (!DetectorBackend::parseType(argv[++i], options.detector)) {
+                printBatchUsage();
+                return 2;
+            }
+        } else if ((arg == "--detector-model" || arg == "--cascade") && hasValue) {
+            options.detectorModel = argv[++i];
+        } else if (arg == "--detector-config" && hasValue) {
+            options.detectorConfig = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            printBatchUsage();
+            return 2;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+
+    if (options.inputs.empty()) {
+        printBatchUsage();
+        return 2;
+    }
+
+    FaceRecognizer recognizer;
+    if (!recognizer.initialize(recognizerType, recognizerModel)) {
+        std::fprintf(stderr, "Failed to load the %s recognizer\n", RecognizerBackend::typeName(recognizerType));
+        return 1;
+    }
+    if (modelFile.empty()) {
+        modelFile = RecognizerBackend::defaultGalleryFile(recognizerType);
+    }
+    // Before loading, so a saved index is used instead of rebuilt
+    if (efSearch > 0) {
+        recognizer.setApproximateSearch(true, efSearch);
+    }
+    if (!recognizer.loadModel(modelFile)) {
+        std::fprintf(stderr, "Failed to load recognition model: %s\n", modelFile.c_str());
+        return 1;
+    }
+
+    BatchProcessor processor(recognizer, options);
+    std::fprintf(stderr, "Detector: %s, recognizer: %s\n", DetectorBackend::typeName(options.detector),
+        RecognizerBackend::typeName(recognizerType));
+    std::printf("source,frame,seconds,name,confidence\n");
+
+    bool ok = processor.run(
+        [](const AttendanceEvent& event) {
+            std::printf("%s,%lld,%.3f,%s,%.2f\n", csvField(event.source).c_str(),
+                static_cast<long long>(event.frame), event.seconds,
+                csvField(event.name).c_str(), event.confidence);
+            std::fflush(stdout);
+        },
+        [](const BatchFileStats& stats) {
+            double fps = stats.wallSeconds > 0.0 ? stats.frames / stats.wallSeconds : 0.0;
+            double speedup = stats.wallSeconds > 0.0 ? stats.mediaSeconds / stats.wallSeconds : 0.0;
+            std::fprintf(stderr, "%s: %llu frames, %llu faces in %.2f s (%.1f fps, %.1fx real time, detect %.2f ms/frame)\n",
+                stats.source.c_str(), static_cast<unsigned long long>(stats.frames),
+                static_cast<unsigned long long>(stats.faces), stats.wallSeconds, fps, speedup, stats.detectMs);
+        });
+
+    if (!ok) {
+        std::fprintf(stderr, "Some inputs could not be processed\n");
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0) {
+            return runBatch(argc, argv);
+        }
+        if (std::strcmp(argv[i], "--convert-model") == 0) {
+            if (i + 2 >= argc) {
+                printBatchUsage();
+                return 2;
+            }
+            return runConvert(argv[i + 1], argv[i + 2]);
+        }
+    }
+
     QApplication app(argc, argv);
     MainWindow window;
     window.show();
     return app.exec();
-} 
\ No newline at end of file
+}